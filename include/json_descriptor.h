@@ -1,3 +1,4 @@
+#pragma once
 #include "json_cpp/json_base.h"
 #include <unordered_map>
 #include <memory>
@@ -23,7 +24,7 @@ namespace json_cpp {
         virtual Json_descriptor_ptr new_item() const {
             return std::make_unique<Json_descriptor>();
         };
-        virtual Json_descriptor_type get_type() { return Json_descriptor_type::Null; };
+        virtual Json_descriptor_type get_type() const { return Json_descriptor_type::Null; };
         void json_parse(std::istream &) override;
         void json_write(std::ostream &) const override;
         virtual ~Json_descriptor() = default;
@@ -46,7 +47,7 @@ namespace json_cpp {
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_bool_descriptor>(value);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::Bool;}
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::Bool;}
         bool value{};
         void json_parse(std::istream &) override;
         void json_write(std::ostream &) const override;
@@ -59,7 +60,7 @@ namespace json_cpp {
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_int_descriptor>(value);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::Int;}
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::Int;}
         int value{};
         void json_parse(std::istream &) override;
         void json_write(std::ostream &) const override;
@@ -68,12 +69,13 @@ namespace json_cpp {
 
     struct Json_float_descriptor :Json_descriptor {
         Json_float_descriptor() = default;
-        explicit Json_float_descriptor(float value) : value(value) {};
+        explicit Json_float_descriptor(double value) : value(value) {};
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_float_descriptor>(value);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::Float;}
-        float value{};
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::Float;}
+        // written with the shortest text that reads back to the same double
+        double value{};
         void json_parse(std::istream &) override;
         void json_write(std::ostream &) const override;
         ~Json_float_descriptor() override = default;
@@ -85,7 +87,7 @@ namespace json_cpp {
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_string_descriptor>(value);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::String;}
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::String;}
         std::string value{};
         void json_parse(std::istream &) override;
         void json_write(std::ostream &) const override;
@@ -100,7 +102,7 @@ namespace json_cpp {
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_list_descriptor>(value, allow_null_values);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::List;}
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::List;}
         bool allow_null_values = true;
         Json_descriptor_container value{};
         Json_descriptor_ptr item_descriptor;
@@ -121,7 +123,7 @@ namespace json_cpp {
                 return std::make_unique<Json_variant_descriptor>();
         };
         Json_descriptor_ptr value{};
-        Json_descriptor_type get_type() override {
+        Json_descriptor_type get_type() const override {
             if (value) return value->get_type();
             return Json_descriptor_type::Null;
         }
@@ -137,18 +139,20 @@ namespace json_cpp {
         [[nodiscard]] Json_descriptor_ptr new_item() const override {
             return std::make_unique<Json_object_descriptor>(*this);
         };
-        Json_descriptor_type get_type() override {return Json_descriptor_type::Object;}
-        void add_member(const std::string &, Json_descriptor &, bool member_mandatory);
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::Object;}
+        void add_member(const std::string &, const Json_descriptor &, bool member_mandatory);
         Json_descriptor_container members_descriptor;
         std::vector<std::string> members_name;
         std::vector<bool> members_mandatory;
         bool allow_undefined_members{true};
-        void set(const std::string &, Json_descriptor &);
+        void set(const std::string &, const Json_descriptor &);
         void set(const std::string &, bool);
         void set(const std::string &, int);
         void set(const std::string &, float);
+        void set(const std::string &, double);
         void set(const std::string &, std::string);
         Json_descriptor &get(const std::string);
+        void remove(const std::string &);
         int find(const std::string &);
         bool contains(const std::string &);
         void json_parse(std::istream &) override;
@@ -156,4 +160,12 @@ namespace json_cpp {
         ~Json_object_descriptor() override = default;
     };
 
+    // follows variant descriptors down to the descriptor holding the value
+    const Json_descriptor &json_resolve(const Json_descriptor &);
+    Json_descriptor &json_resolve(Json_descriptor &);
+
+    // shortest text that reads back to the same value. the stream precision is not used
+    void json_write_number(std::ostream &, double);
+    void json_write_number(std::ostream &, float);
+
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+#include "json_descriptor.h"
+
+namespace json_cpp {
+
+    // structural comparison of two descriptor trees. ints and floats are compared by value.
+    bool json_equal(const Json_descriptor &, const Json_descriptor &);
+
+    // json patch (RFC 6902): a list of operations turning the first document into the second.
+    // identical subtrees produce no operations, lists are diffed after trimming their common prefix and suffix.
+    Json_descriptor_ptr diff(const Json_descriptor &, const Json_descriptor &);
+
+    // json merge patch (RFC 7386) turning the first document into the second.
+    Json_descriptor_ptr merge_diff(const Json_descriptor &, const Json_descriptor &);
+
+    // applies a json patch in place. operations are applied in order: when one fails an exception is thrown
+    // and the operations before it remain applied. members added by the patch are optional.
+    // a typed root keeps its type: pass a Json_variant_descriptor to let the patch replace it by any value.
+    void apply_patch(Json_descriptor &, const Json_descriptor &);
+
+    // applies a json merge patch in place, same rules as apply_patch.
+    void apply_merge_patch(Json_descriptor &, const Json_descriptor &);
+}
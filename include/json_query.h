@@ -0,0 +1,52 @@
+#pragma once
+#include "json_descriptor.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// query operators over list descriptors. the list is split in contiguous chunks processed in parallel,
+// results keep the order of the list. paths are dotted member names ("address.street", list items
+// by index "points.0"), an empty path refers to the item itself. missing members evaluate to null.
+
+namespace json_cpp {
+
+    enum class Json_query_operator {
+        Equal,
+        Not_equal,
+        Less,
+        Less_equal,
+        Greater,
+        Greater_equal
+    };
+
+    // "==", "!=", "<", "<=", ">", ">="
+    Json_query_operator get_query_operator(const std::string &);
+
+    // numbers at a path. nulls and missing members are not counted. when all the values are ints
+    // integer_sum holds their exact sum, sum adds every value as a double.
+    struct Json_query_aggregate {
+        size_t count{0};
+        bool integer{true};
+        int64_t integer_sum{0};
+        double sum{0};
+        double min{0};
+        double max{0};
+    };
+
+    std::vector<size_t> where_indices(const Json_list_descriptor &, const std::string &path, Json_query_operator, const Json_descriptor &);
+    Json_descriptor_ptr where(const Json_list_descriptor &, const std::string &path, Json_query_operator, const Json_descriptor &);
+    Json_descriptor_ptr select_members(const Json_list_descriptor &, const std::vector<std::string> &members);
+    Json_descriptor_ptr column(const Json_list_descriptor &, const std::string &path);
+    Json_query_aggregate aggregate(const Json_list_descriptor &, const std::string &path);
+    // key is a copy of the first value of the group, null for nulls and missing members
+    struct Json_query_group {
+        Json_descriptor_ptr key;
+        std::vector<size_t> indices;
+    };
+
+    // groups in order of first appearance. values are grouped when they are equal in type and value,
+    // except numbers that are compared by value (1 and 1.0 share a group)
+    std::vector<Json_query_group> group_by_indices(const Json_list_descriptor &, const std::string &path);
+    // list of {"key":value,"items":[...]}
+    Json_descriptor_ptr group_by(const Json_list_descriptor &, const std::string &path);
+}
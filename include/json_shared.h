@@ -0,0 +1,83 @@
+#pragma once
+#include "json_descriptor.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// relocatable flat form of a descriptor tree. every reference inside the document is an offset from its
+// start, so it can be placed in a posix shared memory segment or a memory mapped file and read in place
+// by any process mapping it, at any address. attaching maps the memory read-only and checks the header:
+// nothing is decoded and the physical pages are shared by all the readers.
+//
+// layout: a header followed by nodes {type, value} aligned to 8 bytes. strings store their length and
+// bytes, lists the offsets of their items, objects the offsets of their member names and values in
+// insertion order followed by the member positions sorted by name for binary search lookups.
+
+namespace json_cpp {
+
+    // read-only view of a value inside a shared document. it points into the document memory,
+    // so it is only valid while the document is attached.
+    struct Json_shared_value {
+        using Json_descriptor_type = Json_descriptor::Json_descriptor_type;
+        Json_shared_value(const char *data, size_t size, uint64_t offset);
+        Json_descriptor_type get_type() const;
+        bool is_null() const;
+        bool get_bool() const;
+        int64_t get_int() const;
+        // ints are converted
+        double get_float() const;
+        std::string_view get_string() const;
+        // items of a list or members of an object
+        size_t size() const;
+        // list item
+        Json_shared_value operator[](size_t) const;
+        // object member, throws when the member is not defined
+        Json_shared_value operator[](std::string_view) const;
+        bool find(std::string_view, Json_shared_value &) const;
+        bool contains(std::string_view) const;
+        // object member name and value in insertion order
+        std::string_view key(size_t) const;
+        Json_shared_value value(size_t) const;
+        void json_write(std::ostream &) const;
+        std::string to_json() const;
+        // decodes the value into a new descriptor tree
+        Json_descriptor_ptr to_descriptor() const;
+    private:
+        uint64_t read(uint64_t) const;
+        uint64_t expect(Json_descriptor_type) const;
+        const char *data;
+        size_t data_size;
+        uint64_t offset;
+    };
+
+    struct Json_shared_document {
+        // serializes the descriptor into a new shared memory segment. fails if the segment already exists.
+        // on windows the segment is released when no process has it attached and unlink does nothing.
+        static Json_shared_document create(const std::string &name, const Json_descriptor &);
+        static Json_shared_document attach(const std::string &name);
+        static void unlink(const std::string &name);
+        // same on a memory mapped file. the file is written under a temporary name and renamed when complete,
+        // so on posix systems readers attached to a previous version keep their mapping. windows does not
+        // replace a file while it is mapped: create_file fails until every reader of the previous version detached.
+        static Json_shared_document create_file(const std::string &file_path, const Json_descriptor &);
+        static Json_shared_document attach_file(const std::string &file_path);
+        // flat form in memory, to be written or sent by other means
+        static std::string serialize(const Json_descriptor &);
+        // view over a serialized document owned by the caller
+        Json_shared_document(const char *data, size_t size);
+        Json_shared_document(Json_shared_document &&) noexcept;
+        Json_shared_document &operator = (Json_shared_document &&) noexcept;
+        Json_shared_document(const Json_shared_document &) = delete;
+        Json_shared_document &operator = (const Json_shared_document &) = delete;
+        ~Json_shared_document();
+        Json_shared_value root() const;
+        const char *data() const;
+        size_t size() const;
+    private:
+        Json_shared_document(const char *data, size_t size, size_t mapping_size);
+        const char *memory{nullptr};
+        size_t memory_size{0};
+        // 0 when the memory is not owned
+        size_t mapping_size{0};
+    };
+}
@@ -0,0 +1,320 @@
+#pragma once
+#include "json_descriptor.h"
+#include "json_cpp/json_util.h"
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// compile-time typed descriptors: the schema is given as template parameters and values are parsed
+// and written straight into plain structs, without building descriptor nodes or virtual dispatch per value.
+//
+//  struct Person {
+//      int64_t id;
+//      std::vector<std::string> tags;
+//  };
+//  constexpr char person_id[] = "id";
+//  constexpr char person_tags[] = "tags";
+//  using Person_descriptor = json_cpp::Json_static_object<Person,
+//          json_cpp::Json_static_member<person_id, &Person::id>,
+//          json_cpp::Json_static_member<person_tags, &Person::tags, false>>;
+//
+// Json_static_object is a Json_descriptor, so it can be added as a member of a Json_object_descriptor or used as
+// the item descriptor of a Json_list_descriptor. members can also be dynamic descriptors (any Json_base).
+// to nest a plain struct, map it to its descriptor by specializing the codec:
+//
+//  template<> struct json_cpp::Json_static_codec<Person> : Person_descriptor {};
+
+namespace json_cpp {
+
+    // fnv-1a, used for the key tables
+    constexpr uint32_t json_static_hash(const char *s, uint32_t h = 2166136261u) {
+        return *s ? json_static_hash(s + 1, (h ^ (uint8_t) *s) * 16777619u) : h;
+    }
+
+    inline uint32_t json_static_hash(const std::string &s) {
+        uint32_t h = 2166136261u;
+        for (char c: s) h = (h ^ (uint8_t) c) * 16777619u;
+        return h;
+    }
+
+    constexpr bool json_static_equal(const char *a, const char *b) {
+        while (*a && *a == *b) {
+            a++;
+            b++;
+        }
+        return *a == *b;
+    }
+
+    template <class T, class Enable = void>
+    struct Json_static_codec;
+
+    template <>
+    struct Json_static_codec<bool> {
+        static void parse(std::istream &i, bool &v) {
+            v = Json_util::read_bool(i);
+        }
+        static void write(std::ostream &o, const bool &v) {
+            Json_util::write_value(o, v);
+        }
+    };
+
+    template <class T>
+    struct Json_static_codec<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        static void parse(std::istream &i, T &v) {
+            char c = Json_util::skip_blanks(i);
+            bool negative = c == '-';
+            if (negative) {
+                if (std::is_unsigned_v<T>) throw std::logic_error("format error: negative value for unsigned member");
+                Json_util::discard(i);
+                c = (char) i.peek();
+            }
+            if (c < '0' || c > '9') throw std::logic_error("format error: expecting integer");
+            unsigned long long limit = negative ?
+                    (unsigned long long) std::numeric_limits<T>::max() + 1 :
+                    (unsigned long long) std::numeric_limits<T>::max();
+            unsigned long long r = 0;
+            while ((c = (char) i.peek()) >= '0' && c <= '9') {
+                unsigned long long d = (unsigned long long) (c - '0');
+                if (r > (limit - d) / 10) throw std::logic_error("format error: integer out of range");
+                r = r * 10 + d;
+                Json_util::discard(i);
+            }
+            if (c == '.' || c == 'e' || c == 'E') throw std::logic_error("format error: expecting integer");
+            v = negative && r ? (T) (-(long long) (r - 1) - 1) : (T) r;
+        }
+        static void write(std::ostream &o, const T &v) {
+            o << (std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>) v;
+        }
+    };
+
+    template <class T>
+    struct Json_static_codec<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        static void parse(std::istream &i, T &v) {
+            v = (T) Json_util::read_double(i);
+        }
+        // same formatting as Json_float_descriptor: shortest text that reads back to the same value
+        static void write(std::ostream &o, const T &v) {
+            if constexpr (std::is_same_v<T, float>) json_write_number(o, v);
+            else json_write_number(o, (double) v);
+        }
+    };
+
+    template <>
+    struct Json_static_codec<std::string> {
+        static void parse(std::istream &i, std::string &v) {
+            v = Json_util::read_string(i);
+        }
+        static void write(std::ostream &o, const std::string &v) {
+            Json_util::write_value(o, v);
+        }
+    };
+
+    template <class T>
+    struct Json_static_codec<std::vector<T>> {
+        static void parse(std::istream &i, std::vector<T> &v) {
+            if (Json_util::skip_blanks(i) != '[') throw std::logic_error("format error: expecting '['");
+            Json_util::discard(i);
+            v.clear();
+            while (Json_util::skip_blanks(i) != ']') {
+                T item{};
+                Json_static_codec<T>::parse(i, item);
+                v.push_back(std::move(item));
+                if (Json_util::skip_blanks(i) != ',') break;
+                Json_util::discard(i);
+            }
+            if (Json_util::skip_blanks(i, true) != ']') throw std::logic_error("format error: expecting ']'");
+        }
+        static void write(std::ostream &o, const std::vector<T> &v) {
+            o << '[';
+            bool first = true;
+            for (const auto &item: v) {
+                if (!first) o << ',';
+                first = false;
+                Json_static_codec<T>::write(o, item);
+            }
+            o << ']';
+        }
+    };
+
+    // null is read and written as an empty optional
+    template <class T>
+    struct Json_static_codec<std::optional<T>> {
+        static void parse(std::istream &i, std::optional<T> &v) {
+            if (Json_util::skip_blanks(i) == 'n') {
+                Json_util::read_null(i);
+                v.reset();
+                return;
+            }
+            T item{};
+            Json_static_codec<T>::parse(i, item);
+            v = std::move(item);
+        }
+        static void write(std::ostream &o, const std::optional<T> &v) {
+            if (v) Json_static_codec<T>::write(o, *v);
+            else o << "null";
+        }
+    };
+
+    // dynamic descriptors and any other Json_base
+    template <class T>
+    struct Json_static_codec<T, std::enable_if_t<std::is_base_of_v<Json_base, T>>> {
+        static void parse(std::istream &i, T &v) {
+            v.json_parse(i);
+        }
+        static void write(std::ostream &o, const T &v) {
+            v.json_write(o);
+        }
+    };
+
+    template <class P>
+    struct Json_static_member_pointer;
+
+    template <class C, class M>
+    struct Json_static_member_pointer<M C::*> {
+        using owner_type = C;
+        using value_type = M;
+    };
+
+    template <const char *Name, auto Member, bool Mandatory = true>
+    struct Json_static_member {
+        using owner_type = typename Json_static_member_pointer<decltype(Member)>::owner_type;
+        using value_type = typename Json_static_member_pointer<decltype(Member)>::value_type;
+        static constexpr const char *name = Name;
+        static constexpr uint32_t hash = json_static_hash(Name);
+        static constexpr bool mandatory = Mandatory;
+        static void parse(std::istream &i, owner_type &o) {
+            Json_static_codec<value_type>::parse(i, o.*Member);
+        }
+        static void reset(owner_type &o) {
+            o.*Member = value_type{};
+        }
+        static void write(std::ostream &o, const owner_type &v) {
+            // escaped like the names of Json_object_descriptor members, once per member
+            static const std::string key = [] {
+                std::stringstream s;
+                Json_util::write_value(s, std::string(Name));
+                s << ':';
+                return s.str();
+            }();
+            o << key;
+            Json_static_codec<value_type>::write(o, v.*Member);
+        }
+    };
+
+    template <class... Members>
+    constexpr bool json_static_unique_names() {
+        const char *names[] = {Members::name...};
+        for (size_t a = 0; a < sizeof...(Members); a++)
+            for (size_t b = a + 1; b < sizeof...(Members); b++)
+                if (json_static_equal(names[a], names[b])) return false;
+        return true;
+    }
+
+    // runtime access to the member table of a Json_static_object, used by validate
+    struct Json_static_object_base : Json_descriptor {
+        bool allow_undefined_members{true};
+        virtual size_t member_count() const = 0;
+        virtual const char *member_name(size_t) const = 0;
+        virtual bool member_mandatory(size_t) const = 0;
+        virtual int member_index(const std::string &) const = 0;
+        // parses one member value with its codec and discards it, throws as parse does
+        virtual void check_member(size_t, std::istream &) const = 0;
+    };
+
+    template <class T, class... Members>
+    struct Json_static_object : Json_static_object_base {
+        static_assert(sizeof...(Members) > 0, "Json_static_object requires at least one member");
+        static_assert(json_static_unique_names<Members...>(), "duplicated member name");
+        static_assert((std::is_same_v<T, typename Members::owner_type> && ...), "members must belong to the described type");
+
+        Json_static_object() = default;
+        explicit Json_static_object(T value) : value(std::move(value)) {};
+        [[nodiscard]] Json_descriptor_ptr new_item() const override {
+            return std::make_unique<Json_static_object>(value);
+        };
+        Json_descriptor_type get_type() const override {return Json_descriptor_type::Object;}
+        T value{};
+        void json_parse(std::istream &i) override {
+            parse(i, value, allow_undefined_members);
+        }
+        void json_write(std::ostream &o) const override {
+            write(o, value);
+        }
+
+        static constexpr size_t size = sizeof...(Members);
+        static constexpr const char *names[] = {Members::name...};
+        static constexpr uint32_t hashes[] = {Members::hash...};
+        static constexpr bool mandatory[] = {Members::mandatory...};
+
+        size_t member_count() const override {return size;}
+        const char *member_name(size_t m) const override {return names[m];}
+        bool member_mandatory(size_t m) const override {return mandatory[m];}
+        int member_index(const std::string &name) const override {return find(name);}
+        void check_member(size_t m, std::istream &i) const override {
+            T item{};
+            parse_member(m, i, item);
+        }
+
+        static int find(const std::string &name) {
+            auto h = json_static_hash(name);
+            for (size_t m = 0; m < size; m++) {
+                if (hashes[m] == h && name == names[m]) return (int) m;
+            }
+            return -1;
+        }
+
+        static void parse(std::istream &i, T &value, bool allow_undefined_members = true) {
+            if (Json_util::skip_blanks(i) != '{') throw std::logic_error("format error: expecting '{'");
+            Json_util::discard(i);
+            bool loaded[size] = {};
+            std::string name;
+            while (Json_util::skip_blanks(i) != '}') {
+                if (!Json_util::read_name(name, i)) throw std::logic_error("format error: field name");
+                int m = find(name);
+                if (m >= 0) {
+                    if (loaded[m]) throw std::logic_error("duplicated definition found for member " + name);
+                    // as in Json_object_descriptor: null is only accepted by non mandatory members
+                    if (Json_util::skip_blanks(i) == 'n') {
+                        if (mandatory[m]) throw std::logic_error("member " + name + " is mandatory.");
+                        Json_util::read_null(i);
+                        reset_member((size_t) m, value);
+                    } else {
+                        parse_member((size_t) m, i, value);
+                    }
+                    loaded[m] = true;
+                } else {
+                    if (!allow_undefined_members) throw std::logic_error("member " + name + " is not defined.");
+                    Json_variant_descriptor().json_parse(i);
+                }
+                if (Json_util::skip_blanks(i) != ',') break;
+                Json_util::discard(i);
+            }
+            if (Json_util::skip_blanks(i) != '}') throw std::logic_error("format error: expecting '}'");
+            Json_util::discard(i);
+            for (size_t m = 0; m < size; m++) {
+                if (mandatory[m] && !loaded[m]) throw std::logic_error("member " + std::string(names[m]) + " is mandatory.");
+            }
+        }
+
+        static void write(std::ostream &o, const T &value) {
+            o << '{';
+            size_t m = 0;
+            ((o << (m++ ? "," : ""), Members::write(o, value)), ...);
+            o << '}';
+        }
+
+    private:
+        static void parse_member(size_t index, std::istream &i, T &value) {
+            size_t m = 0;
+            ((m++ == index && (Members::parse(i, value), true)) || ...);
+        }
+        static void reset_member(size_t index, T &value) {
+            size_t m = 0;
+            ((m++ == index && (Members::reset(value), true)) || ...);
+        }
+    };
+}
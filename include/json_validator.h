@@ -0,0 +1,25 @@
+#pragma once
+#include "json_descriptor.h"
+#include <string>
+
+namespace json_cpp {
+
+    // outcome of a validation pass. when valid is false, path holds the json pointer (RFC 6901)
+    // of the offending value, offset the byte position in the buffer where the problem was found
+    // and reason a human readable description.
+    struct Json_validation_result {
+        bool valid{true};
+        std::string path;
+        size_t offset{0};
+        std::string reason;
+        explicit operator bool() const { return valid; }
+    };
+
+    // checks that buffer holds a single json value conforming to schema without materializing it:
+    // types, mandatory members, undefined members (allow_undefined_members) and nulls
+    // (allow_null_values) are checked in one pass and no value is allocated.
+    // Json_variant_descriptor schemas (and lists without item descriptor) accept any value.
+    // Json_static_object schemas are checked through their member table, each member value being read by its codec.
+    Json_validation_result validate(const Json_descriptor &schema, const char *buffer, size_t size);
+    Json_validation_result validate(const Json_descriptor &schema, const std::string &buffer);
+}
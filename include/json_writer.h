@@ -0,0 +1,60 @@
+#pragma once
+#include "json_descriptor.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace json_cpp {
+
+    // serializes descriptors straight to a file through a reusable output buffer, so the json text
+    // of the whole output is never held in memory. in Array mode the records are written as a
+    // single json list, in Ndjson mode one record per line and in Value mode a single record is accepted.
+    // when background is set, full buffers are handed to a flushing thread while the next one is encoded.
+    struct Json_writer : std::streambuf {
+        enum class Json_writer_mode {
+            Value,
+            Array,
+            Ndjson
+        };
+        explicit Json_writer(const std::string &file_path,
+                             Json_writer_mode mode = Json_writer_mode::Array,
+                             size_t buffer_size = 1 << 16,
+                             bool background = false);
+        Json_writer(const Json_writer &) = delete;
+        Json_writer &operator = (const Json_writer &) = delete;
+        void write(const Json_descriptor &);
+        void write(const std::string &);
+        void flush();
+        void close();
+        // closes the file without terminating the list in Array mode, so an interrupted output is not valid json
+        void abort();
+        bool is_open() const;
+        size_t records{0};
+        ~Json_writer() override;
+    protected:
+        int overflow(int) override;
+        std::streamsize xsputn(const char *, std::streamsize) override;
+    private:
+        void begin_record();
+        void end_record();
+        void finish(bool);
+        void submit();
+        void flush_loop();
+        void check_error();
+        FILE *file{nullptr};
+        Json_writer_mode mode;
+        std::ostream stream;
+        std::vector<char> buffer;
+        std::vector<char> pending;
+        size_t pending_size{0};
+        bool pending_ready{false};
+        bool stopping{false};
+        std::string error;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::thread flusher;
+    };
+}
@@ -2,4 +2,5 @@ from .json_parsable import JsonParsable
 from .json_parser import JsonParser
 from .json_object import JsonObject
 from .json_list import JsonList
-
+from .json_writer import JsonWriter
+from .json_shared import JsonSharedDocument
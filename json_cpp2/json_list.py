@@ -73,6 +73,10 @@ class JsonList(list, json_cpp2.JsonParsable):
             json_descriptor.__iadd__(json_cpp2.JsonParser.__create_descriptor__(i))
         return json_descriptor
 
+    def __query_descriptor__(self):
+        # values of the items converted by a single native call, the native queries run on it
+        return json_cpp2_core.create_descriptor(self)
+
     def __from_descriptor__(self, json_descriptor: json_cpp2_core.JsonListDescriptor):
         self.clear()
         for i in range(len(json_descriptor)):
@@ -207,7 +211,8 @@ class JsonList(list, json_cpp2.JsonParsable):
 
     def get(self, member_name:str) -> json_cpp2.JsonParsable:
         """
-        Copies a member from on every element of the list into a new list.
+        Copies a member from on every element of the list into a new list. The members are read natively and
+        not copied: the new list holds the same values, missing members are None.
 
         :param member_name: the name of the member to be copied to the new list
         :type member_name: str
@@ -225,18 +230,18 @@ class JsonList(list, json_cpp2.JsonParsable):
         >>> l.get('y')
         [15, 25, 35]
         """
-        if not issubclass(self._list_type, json_cpp2.JsonObject):
+        if self._list_type and not issubclass(self._list_type, json_cpp2.JsonObject):
             raise TypeError("get can only be used with json_object list types")
         if len(self) == 0:
             return JsonList()
         new_list = JsonList()
-        for i in self:
-            new_list.append(i[member_name])
+        list.extend(new_list, json_cpp2_core.member_values(self, member_name))
         return new_list
 
     def select(self, member_names) -> json_cpp2.JsonParsable:
         """
-        Creates a list of objects with new objects of a new type containing with a subset of members from the originals
+        Creates a list of objects with new objects of a new type containing with a subset of members from the originals.
+        The members are not copied: the new objects hold the same values, missing members are set to None
 
         :param member_names: list of member to be included in the new list
         :type member_names: list of str
@@ -252,33 +257,162 @@ class JsonList(list, json_cpp2.JsonParsable):
         [{"x":10,"y":15}, {"x":20,"y":25}, {"x":30,"y":35}]
 
         """
-        if self._list_type is not self._list_type and not issubclass(self._list_type, json_cpp2.JsonObject):
+        if self._list_type and not issubclass(self._list_type, json_cpp2.JsonObject):
             raise TypeError("select can only be used with json_object list types")
 
         if len(self) == 0:
             return JsonList()
 
+        member_names = tuple(member_names)
         new_list = JsonList(json_cpp2.JsonObject)
         for i in self:
-            new_list.append(i.select(member_names))
+            list.append(new_list, i.select(member_names))
         return new_list
 
-    def where(self, lambda_criteria) -> json_cpp2.JsonParsable:
+    def where(self, criteria, op: str = None, value=None) -> json_cpp2.JsonParsable:
         """
-        Creates a list with elements that passes a criteria
-
-        :param lambda_criteria: lambda receiving each element and returning a bool
-        :type lambda_criteria: lambda
+        Creates a list with elements that passes a criteria. When the criteria is a member path, the comparison
+        runs natively in parallel.
+
+        :param criteria: lambda receiving each element and returning a bool, or a member path ('x', 'position.x')
+        :type criteria: lambda or str
+        :param op: comparison operator used with a member path: '==', '!=', '<', '<=', '>' or '>='
+        :type op: str
+        :param value: value compared with the member
+        :type value: any supported value type
         :return: the new list
         :rtype: JsonList
+        :Example:
 
+        >>> from json_cpp2 import JsonObject
+        >>> l = JsonList(JsonObject)
+        >>> l.append(JsonObject(x=10, y=15))
+        >>> l.append(JsonObject(x=20, y=25))
+        >>> l.append(JsonObject(x=30, y=35))
+        >>> l.where('x', '>', 15)
+        [{"x":20,"y":25}, {"x":30,"y":35}]
+        >>> l.where(lambda i: i.y == 15)
+        [{"x":10,"y":15}]
         """
         nl = JsonList(self._list_type)
-        for i in self:
-            if lambda_criteria(i):
-                nl.append(i)
+        if callable(criteria):
+            for i in self:
+                if criteria(i):
+                    nl.append(i)
+            return nl
+        if op is None:
+            raise TypeError("incorrect parameter: expected callable or member path, operator and value")
+        indices = json_cpp2_core.where_indices(self.__query_descriptor__(),
+                                               criteria,
+                                               op,
+                                               json_cpp2_core.create_descriptor(value))
+        list.extend(nl, [self[index] for index in indices])
         return nl
 
+    def count(self, criteria=None, op: str = None, value=None) -> int:
+        """
+        Counts the elements that pass a criteria (see where). without criteria counts all the elements
+
+        :Example:
+
+        >>> from json_cpp2 import JsonObject
+        >>> l = JsonList(JsonObject)
+        >>> l.append(JsonObject(x=10))
+        >>> l.append(JsonObject(x=20))
+        >>> l.count('x', '>=', 20)
+        1
+        """
+        if criteria is None:
+            return len(self)
+        if callable(criteria):
+            return len(self.where(criteria))
+        return len(json_cpp2_core.where_indices(self.__query_descriptor__(),
+                                                criteria,
+                                                op,
+                                                json_cpp2_core.create_descriptor(value)))
+
+    def __aggregate__(self, path: str):
+        return json_cpp2_core.aggregate(self.__query_descriptor__(), path)
+
+    def sum(self, path: str = ""):
+        """
+        Adds the numeric values of a member (nulls and missing members are skipped). ints are added exactly
+
+        :param path: member path ('x', 'position.x'). empty for lists of numbers
+        :type path: str
+        :Example:
+
+        >>> JsonList(int, [1, 2, 3]).sum()
+        6
+        """
+        aggregate = self.__aggregate__(path)
+        return aggregate.integer_sum if aggregate.integer else aggregate.sum
+
+    def min(self, path: str = ""):
+        """
+        Minimum of the numeric values of a member, None when there are no values
+
+        :param path: member path ('x', 'position.x'). empty for lists of numbers
+        :type path: str
+        :Example:
+
+        >>> JsonList(float, [1.5, 0.5, 3.0]).min()
+        0.5
+        """
+        aggregate = self.__aggregate__(path)
+        if not aggregate.count:
+            return None
+        return int(aggregate.min) if aggregate.integer else aggregate.min
+
+    def max(self, path: str = ""):
+        """
+        Maximum of the numeric values of a member, None when there are no values
+
+        :param path: member path ('x', 'position.x'). empty for lists of numbers
+        :type path: str
+        :Example:
+
+        >>> JsonList(int, [1, 5, 3]).max()
+        5
+        """
+        aggregate = self.__aggregate__(path)
+        if not aggregate.count:
+            return None
+        return int(aggregate.max) if aggregate.integer else aggregate.max
+
+    def group_by(self, path: str) -> dict:
+        """
+        Groups the elements by the value of a member, in order of first appearance. the keys are the values
+        themselves, None for nulls and missing members. values python considers equal (1, 1.0 and True) share a group
+
+        :raises TypeError: when a value is an object or a list
+        :param path: member path ('x', 'position.x')
+        :type path: str
+        :return: dictionary of lists
+        :rtype: dict
+        :Example:
+
+        >>> from json_cpp2 import JsonObject
+        >>> l = JsonList(JsonObject)
+        >>> l.append(JsonObject(kind="a", x=1))
+        >>> l.append(JsonObject(kind="b", x=2))
+        >>> l.append(JsonObject(kind="a", x=3))
+        >>> l.group_by('kind')
+        {'a': [{"kind":"a","x":1}, {"kind":"a","x":3}], 'b': [{"kind":"b","x":2}]}
+        """
+        groups = dict()
+        for key_descriptor, indices in json_cpp2_core.group_by_indices(self.__query_descriptor__(), path):
+            key = json_cpp2.JsonParser.__get_value__(key_descriptor)
+            if isinstance(key, (json_cpp2.JsonObject, json_cpp2.JsonList)):
+                raise TypeError("group_by can only be used with null, bool, number or string values")
+            if key in groups:
+                indices = sorted(groups[key] + indices)
+            groups[key] = indices
+        for key, indices in groups.items():
+            groups[key] = JsonList(self._list_type)
+            list.extend(groups[key], [self[index] for index in indices])
+        return groups
+
     def __copy__(self):
         new_list = type(self)()
         new_list._list_type = self._list_type
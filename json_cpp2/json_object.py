@@ -60,10 +60,10 @@ class JsonObject(json_cpp2.JsonParsable):
         >>> c3.select(("x","y"))
         {"x":10,"y":20}
         '''
-        d = dict()
+        new_object = JsonObject()
         for member in member_names:
-            d[member] = self[member]
-        return JsonObject(**d)
+            setattr(new_object, member, self[member])
+        return new_object
 
     def __get_descriptor__(self):
         json_descriptor = json_cpp2_core.JsonObjectDescriptor()
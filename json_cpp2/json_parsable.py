@@ -1,4 +1,5 @@
 from abc import abstractmethod
+import json_cpp2_core
 
 
 class JsonParsable:
@@ -29,3 +30,38 @@ class JsonParsable:
         if cls is JsonParsable:
             raise RuntimeError()
         return cls().load(json_string)
+
+    @classmethod
+    def validate(cls, json_string):
+        """
+        Checks if a json string conforms to the class specification (types, mandatory members,
+        undefined members and null values) without creating the values
+
+        :param json_string: json string (str or bytes) to be checked
+        :return: the validation result. evaluates to True when valid, otherwise path, offset and reason describe the error
+        :rtype: json_cpp2_core.JsonValidationResult
+        :Example:
+
+        >>> from json_cpp2 import JsonObject
+        >>> Coordinates = JsonObject.create_class("Coordinates", x=int, y=int, _mandatory_members=["x", "y"])
+        >>> bool(Coordinates.validate('{"x":10,"y":20}'))
+        True
+        >>> Coordinates.validate('{"x":10,"y":"20"}')
+        type error: expecting int at '/y' (offset 12)
+        """
+        if cls is JsonParsable:
+            raise RuntimeError()
+        return json_cpp2_core.validate(cls().__get_descriptor__(), json_string)
+
+    @classmethod
+    def validate_batch(cls, json_strings) -> list:
+        """
+        Checks a collection of json strings against the class specification.
+
+        :param json_strings: iterable of json strings (str or bytes)
+        :return: list of validation results in the same order
+        :rtype: list of json_cpp2_core.JsonValidationResult
+        """
+        if cls is JsonParsable:
+            raise RuntimeError()
+        return json_cpp2_core.validate_batch(cls().__get_descriptor__(), json_strings)
@@ -166,7 +166,7 @@ class JsonParser:
         elif value is None:
             return json_cpp2_core.JsonNullDescriptor()
         elif value_type is dict:
-            return json_cpp2.JsonObject(**value)
+            return json_cpp2.JsonObject(**value).__get_descriptor__()
         elif issubclass(value_type, json_cpp2.JsonParsable):
             return value.__get_descriptor__()
         elif hasattr(value, '__getitem__'):
@@ -174,10 +174,305 @@ class JsonParser:
         else:
             raise TypeError("type %s not supported by json-cpp" % str(value_type))
 
+    @staticmethod
+    def diff(source, target, merge_patch: bool = False):
+        """
+        Computes the changes between two values as a json patch (RFC 6902) or a json merge patch (RFC 7386)
+
+        :raises TypeError: if type of a value is not supported
+        :param source: original value
+        :type source: any supported value type
+        :param target: modified value
+        :type target: any supported value type
+        :param merge_patch: produces a json merge patch instead of a json patch
+        :type merge_patch: bool
+        :return: a list of operations (json patch) or the merge patch
+        :rtype: JsonList or JsonObject
+        :Example:
+
+        >>> JsonParser.diff({'a': 10, 'b': 20}, {'a': 10, 'b': 30, 'c': [1]})
+        [{"op":"replace","path":"/b","value":30}, {"op":"add","path":"/c","value":[1]}]
+        >>> JsonParser.diff({'a': 10, 'b': 20}, {'a': 10, 'c': 30}, merge_patch=True)
+        {"b":null,"c":30}
+        """
+        source_descriptor = JsonParser.__create_descriptor__(source)
+        target_descriptor = JsonParser.__create_descriptor__(target)
+        if merge_patch:
+            patch = json_cpp2_core.merge_diff(source_descriptor, target_descriptor)
+        else:
+            patch = json_cpp2_core.diff(source_descriptor, target_descriptor)
+        return JsonParser.__get_value__(patch)
+
+    @staticmethod
+    def __is_object__(value) -> bool:
+        return isinstance(value, (dict, json_cpp2.JsonObject))
+
+    @staticmethod
+    def __has_member__(value, name: str) -> bool:
+        if isinstance(value, dict):
+            return name in value
+        return not name.startswith("_") and name in vars(value)
+
+    @staticmethod
+    def __member__(value, name: str):
+        if isinstance(value, dict):
+            return value[name]
+        return getattr(value, name)
+
+    @staticmethod
+    def __set_member__(value, name: str, member) -> None:
+        if isinstance(value, dict):
+            value[name] = member
+        elif name.startswith("_"):
+            raise RuntimeError("member names starting with '_' are not supported: " + name)
+        else:
+            setattr(value, name, member)
+
+    @staticmethod
+    def __remove_member__(value, name: str):
+        # removes a member and returns how to put it back in its place
+        if isinstance(value, dict):
+            members = list(value.items())
+            del value[name]
+
+            def restore():
+                value.clear()
+                value.update(members)
+        else:
+            members = [(key, getattr(value, key)) for key in value.keys()]
+            delattr(value, name)
+
+            def restore():
+                for key in value.keys():
+                    delattr(value, key)
+                for key, member in members:
+                    setattr(value, key, member)
+        return restore
+
+    @staticmethod
+    def __pointer__(path: str) -> list:
+        if path == "":
+            return []
+        if not path.startswith("/"):
+            raise RuntimeError("invalid json pointer " + path)
+        return [token.replace("~1", "/").replace("~0", "~") for token in path[1:].split("/")]
+
+    @staticmethod
+    def __list_index__(token: str, size: int, allow_end: bool) -> int:
+        if not token.isdigit() or (len(token) > 1 and token[0] == "0"):
+            raise RuntimeError("invalid list index " + token)
+        index = int(token)
+        if index > size or (index == size and not allow_end):
+            raise RuntimeError("index not found.")
+        return index
+
+    @staticmethod
+    def __child__(value, token: str):
+        if JsonParser.__is_object__(value):
+            if not JsonParser.__has_member__(value, token):
+                raise RuntimeError("member not found: " + token)
+            return JsonParser.__member__(value, token)
+        if isinstance(value, list):
+            return value[JsonParser.__list_index__(token, len(value), False)]
+        raise RuntimeError("path not found: " + token)
+
+    @staticmethod
+    def __locate__(value, tokens: list):
+        for token in tokens:
+            value = JsonParser.__child__(value, token)
+        return value
+
+    @staticmethod
+    def __typed_value__(value, value_type):
+        # values taken from a patch become json objects and lists. they are converted when the place
+        # they go to holds a more specific json type
+        if value_type is None or value is None or isinstance(value, value_type):
+            return value
+        if issubclass(value_type, (json_cpp2.JsonObject, json_cpp2.JsonList)) and isinstance(value, (dict, list)):
+            return JsonParser.__get_value__(json_cpp2_core.create_descriptor(value), value_type)
+        return value
+
+    @staticmethod
+    def __patch_add__(root, tokens: list, value, undo: list):
+        if not tokens:
+            return value
+        parent = JsonParser.__locate__(root, tokens[:-1])
+        token = tokens[-1]
+        if JsonParser.__is_object__(parent):
+            if JsonParser.__has_member__(parent, token):
+                previous = JsonParser.__member__(parent, token)
+                JsonParser.__set_member__(parent, token, JsonParser.__typed_value__(value, type(previous)))
+                undo.append(lambda: JsonParser.__set_member__(parent, token, previous))
+            else:
+                JsonParser.__set_member__(parent, token, value)
+                undo.append(lambda: JsonParser.__remove_member__(parent, token))
+        elif isinstance(parent, list):
+            index = len(parent) if token == "-" else JsonParser.__list_index__(token, len(parent), True)
+            if isinstance(parent, json_cpp2.JsonList):
+                value = JsonParser.__typed_value__(value, parent._list_type)
+                parent.__type_check__(value)
+            list.insert(parent, index, value)
+            undo.append(lambda: list.pop(parent, index))
+        else:
+            raise RuntimeError("path not found: " + token)
+        return root
+
+    @staticmethod
+    def __patch_remove__(root, tokens: list, undo: list):
+        if not tokens:
+            raise RuntimeError("cannot remove the root")
+        parent = JsonParser.__locate__(root, tokens[:-1])
+        token = tokens[-1]
+        if JsonParser.__is_object__(parent):
+            if not JsonParser.__has_member__(parent, token):
+                raise RuntimeError("member not found")
+            value = JsonParser.__member__(parent, token)
+            undo.append(JsonParser.__remove_member__(parent, token))
+            return value
+        if isinstance(parent, list):
+            index = JsonParser.__list_index__(token, len(parent), False)
+            value = list.pop(parent, index)
+            undo.append(lambda: list.insert(parent, index, value))
+            return value
+        raise RuntimeError("path not found: " + token)
+
+    @staticmethod
+    def __patch_replace__(root, tokens: list, value, undo: list):
+        if not tokens:
+            return value
+        parent = JsonParser.__locate__(root, tokens[:-1])
+        token = tokens[-1]
+        if JsonParser.__is_object__(parent):
+            if not JsonParser.__has_member__(parent, token):
+                raise RuntimeError("member not found")
+            previous = JsonParser.__member__(parent, token)
+            JsonParser.__set_member__(parent, token, JsonParser.__typed_value__(value, type(previous)))
+            undo.append(lambda: JsonParser.__set_member__(parent, token, previous))
+        elif isinstance(parent, list):
+            index = JsonParser.__list_index__(token, len(parent), False)
+            previous = parent[index]
+            value = JsonParser.__typed_value__(value, type(previous))
+            if isinstance(parent, json_cpp2.JsonList):
+                parent.__type_check__(value)
+            list.__setitem__(parent, index, value)
+            undo.append(lambda: list.__setitem__(parent, index, previous))
+        else:
+            raise RuntimeError("path not found: " + token)
+        return root
+
+    @staticmethod
+    def __operation_member__(operation, name: str):
+        if not JsonParser.__is_object__(operation):
+            raise RuntimeError("json patch operation must be an object")
+        if not JsonParser.__has_member__(operation, name):
+            raise RuntimeError("json patch operation is missing '%s'" % name)
+        return JsonParser.__member__(operation, name)
+
+    @staticmethod
+    def __operation_string__(operation, name: str) -> str:
+        value = JsonParser.__operation_member__(operation, name)
+        if not isinstance(value, str):
+            raise RuntimeError("json patch operation '%s' must be a string" % name)
+        return value
+
+    @staticmethod
+    def __apply_operations__(root, operations, undo: list):
+        from copy import deepcopy
+        if not isinstance(operations, list):
+            raise RuntimeError("json patch must be a list of operations")
+        for operation in operations:
+            op = JsonParser.__operation_string__(operation, "op")
+            path = JsonParser.__operation_string__(operation, "path")
+            tokens = JsonParser.__pointer__(path)
+            if op == "add":
+                root = JsonParser.__patch_add__(root, tokens, deepcopy(JsonParser.__operation_member__(operation, "value")), undo)
+            elif op == "remove":
+                JsonParser.__patch_remove__(root, tokens, undo)
+            elif op == "replace":
+                root = JsonParser.__patch_replace__(root, tokens, deepcopy(JsonParser.__operation_member__(operation, "value")), undo)
+            elif op == "move":
+                from_path = JsonParser.__operation_string__(operation, "from")
+                if path.startswith(from_path + "/"):
+                    raise RuntimeError("cannot move a value into one of its children")
+                value = JsonParser.__patch_remove__(root, JsonParser.__pointer__(from_path), undo)
+                root = JsonParser.__patch_add__(root, tokens, value, undo)
+            elif op == "copy":
+                value = deepcopy(JsonParser.__locate__(root, JsonParser.__pointer__(JsonParser.__operation_string__(operation, "from"))))
+                root = JsonParser.__patch_add__(root, tokens, value, undo)
+            elif op == "test":
+                current = json_cpp2_core.create_descriptor(JsonParser.__locate__(root, tokens))
+                expected = json_cpp2_core.create_descriptor(JsonParser.__operation_member__(operation, "value"))
+                if not json_cpp2_core.json_equal(current, expected):
+                    raise RuntimeError("json patch test failed at " + path)
+            else:
+                raise RuntimeError("unknown json patch operation " + op)
+        return root
+
+    @staticmethod
+    def __merge__(value, patch):
+        # json merge patch on python values, objects are modified in place
+        from copy import deepcopy
+        if not JsonParser.__is_object__(patch):
+            return deepcopy(patch)
+        if not JsonParser.__is_object__(value):
+            value = json_cpp2.JsonObject()
+        for name in (patch if isinstance(patch, dict) else patch.keys()):
+            member = JsonParser.__member__(patch, name)
+            if member is None:
+                if JsonParser.__has_member__(value, name):
+                    JsonParser.__remove_member__(value, name)
+            else:
+                current = JsonParser.__member__(value, name) if JsonParser.__has_member__(value, name) else None
+                merged = JsonParser.__typed_value__(JsonParser.__merge__(current, member), type(current) if current is not None else None)
+                JsonParser.__set_member__(value, name, merged)
+        return value
+
+    @staticmethod
+    def apply_patch(value, patch, merge_patch: bool = False):
+        """
+        Applies a json patch (RFC 6902) or a json merge patch (RFC 7386) to a value.
+        only the paths named by the patch are visited: json objects, dicts and lists are modified in place and
+        returned, members removed by the patch are deleted. replacing the root, or patching an immutable value,
+        returns the new value. when a json patch operation fails the changes already made are undone.
+
+        :raises RuntimeError: when an operation cannot be applied
+        :param value: value to be patched
+        :type value: any supported value type
+        :param patch: the patch as a json string or a value
+        :type patch: str or any supported value type
+        :param merge_patch: the patch is a json merge patch
+        :type merge_patch: bool
+        :return: the patched value
+        :Example:
+
+        >>> value = {'a': 10}
+        >>> JsonParser.apply_patch(value, '[{"op":"add","path":"/b","value":"x"}]') is value
+        True
+        >>> value
+        {'a': 10, 'b': 'x'}
+        >>> JsonParser.apply_patch({'a': 10, 'b': 20}, '{"b":null}', merge_patch=True)
+        {'a': 10}
+        >>> JsonParser.apply_patch(10, '[{"op":"replace","path":"","value":"x"}]')
+        'x'
+        """
+        if isinstance(patch, str):
+            patch = JsonParser.parse(patch)
+        if merge_patch:
+            return JsonParser.__merge__(value, patch)
+        undo = list()
+        try:
+            return JsonParser.__apply_operations__(value, patch, undo)
+        except Exception as e:
+            for step in reversed(undo):
+                step()
+            if isinstance(e, RuntimeError):
+                raise
+            raise RuntimeError(str(e)) from e
+
     @staticmethod
     def to_file(value, file_path: str) -> None:
         """
-        Saves the value to a file in json format
+        Saves the value to a file in json format. lists are streamed one element at a time
 
         :raises TypeError: if type of value is not supported
         :param value: value to be saved
@@ -191,9 +486,12 @@ class JsonParser:
         >>> open('data.json','r').read()
         '{"a":10,"b":20}'
         """
-        json_string = JsonParser.to_json(value)
-        with open(file_path, "w") as f:
-            f.write(json_string)
+        if isinstance(value, (list, tuple)):
+            with json_cpp2.JsonWriter(file_path) as writer:
+                writer.write_all(value)
+        else:
+            with json_cpp2.JsonWriter(file_path, mode="value") as writer:
+                writer.write(value)
 
     @classmethod
     def from_file(cls, file_path: str):
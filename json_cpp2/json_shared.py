@@ -0,0 +1,125 @@
+import json_cpp2_core
+import json_cpp2
+
+
+class JsonSharedDocument:
+    """
+    Read-only json document stored in a flat, relocatable format in posix shared memory or in a memory mapped file.
+    Other processes attach to it without parsing it and read the values in place, sharing the same physical memory.
+    The document can be pickled: the copy received by a multiprocessing worker attaches to the same memory.
+    """
+
+    def __init__(self, name: str = None, file_path: str = None):
+        """
+        Attaches to an existing document
+
+        :param name: name of the shared memory segment
+        :type name: str
+        :param file_path: path of the memory mapped file
+        :type file_path: str
+        """
+        if (name is None) == (file_path is None):
+            raise TypeError("either name or file_path must be provided")
+        self._name = name
+        self._file_path = file_path
+        if name is not None:
+            self._document = json_cpp2_core.JsonSharedDocument.attach(name)
+        else:
+            self._document = json_cpp2_core.JsonSharedDocument.attach_file(file_path)
+
+    @staticmethod
+    def create(value, name: str = None, file_path: str = None):
+        """
+        Writes a value into a new shared memory segment or memory mapped file
+
+        :raises TypeError: if type of value is not supported
+        :raises RuntimeError: if the shared memory segment already exists
+        :param value: value to be shared
+        :type value: any supported value type
+        :param name: name of the shared memory segment
+        :type name: str
+        :param file_path: path of the memory mapped file. an existing file is replaced, on windows only when
+            no process has it attached
+        :type file_path: str
+        :return: the document
+        :rtype: JsonSharedDocument
+        :Example:
+
+        >>> document = JsonSharedDocument.create({"a": [1, 2, 3], "b": {"c": "x"}}, name="json_cpp2_doctest")
+        >>> reader = JsonSharedDocument(name="json_cpp2_doctest")
+        >>> reader["a"][2]
+        3
+        >>> reader.root.b.c
+        'x'
+        >>> reader.load()
+        {"a":[1,2,3],"b":{"c":"x"}}
+        >>> JsonSharedDocument.unlink("json_cpp2_doctest")
+        """
+        if (name is None) == (file_path is None):
+            raise TypeError("either name or file_path must be provided")
+        descriptor = json_cpp2.JsonParser.__create_descriptor__(value)
+        document = JsonSharedDocument.__new__(JsonSharedDocument)
+        document._name = name
+        document._file_path = file_path
+        if name is not None:
+            document._document = json_cpp2_core.JsonSharedDocument.create(name, descriptor)
+        else:
+            document._document = json_cpp2_core.JsonSharedDocument.create_file(file_path, descriptor)
+        return document
+
+    @staticmethod
+    def unlink(name: str) -> None:
+        """
+        Removes a shared memory segment. processes already attached keep their mapping.
+        on windows segments are released when no process has them attached
+        """
+        json_cpp2_core.JsonSharedDocument.unlink(name)
+
+    @property
+    def root(self):
+        """
+        Root value of the document. lists and objects are views over the shared memory. object members can be
+        read as attributes, except the ones named like the view methods (keys, to_json, to_descriptor) that must
+        be read with []. iterating an object yields its keys
+        """
+        return self._document.root()
+
+    @property
+    def size(self) -> int:
+        """
+        Size in bytes of the document
+        """
+        return self._document.size
+
+    def load(self, value_type: type = None):
+        """
+        Decodes the document into python values
+
+        :param value_type: JsonObject or JsonList type to be loaded
+        :type value_type: type
+        :return: the decoded value
+        """
+        root = self._document.root()
+        if not isinstance(root, json_cpp2_core.JsonSharedValue):
+            return root
+        return json_cpp2.JsonParser.__get_value__(root.to_descriptor(), value_type)
+
+    def to_json(self) -> str:
+        return self._document.to_json()
+
+    def __getitem__(self, key):
+        return self.root[key]
+
+    def __len__(self):
+        return len(self.root)
+
+    def __str__(self):
+        return self.to_json()
+
+    def __reduce__(self):
+        return JsonSharedDocument, (self._name, self._file_path)
+
+
+if __name__ == '__main__':
+    import doctest
+    doctest.testmod(optionflags=doctest.ELLIPSIS)
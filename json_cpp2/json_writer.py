@@ -0,0 +1,91 @@
+import json_cpp2_core
+import json_cpp2
+
+
+class JsonWriter:
+    """
+    Streams values to a file in json format without building the whole json string in memory.
+    """
+
+    def __init__(self, file_path: str, mode: str = "array", buffer_size: int = 1 << 16, background: bool = False):
+        """
+        :param file_path: path to the file
+        :type file_path: str
+        :param mode: 'array' writes the values as a json list, 'ndjson' one value per line and 'value' a single value
+        :type mode: str
+        :param buffer_size: size in bytes of the output buffer
+        :type buffer_size: int
+        :param background: writes full buffers to the file from a background thread while encoding continues.
+            values are always encoded on the calling thread holding the GIL, this is the only overlap of encoding and file I/O
+        :type background: bool
+        """
+        self._writer = json_cpp2_core.JsonWriter(file_path, mode, buffer_size, background)
+
+    def write(self, value) -> None:
+        """
+        Writes a value to the file. the value is encoded while holding the GIL, so other python threads
+        wait for it. without background, full buffers are also written to the file before this returns.
+
+        :raises TypeError: if type of value is not supported
+        :param value: value to be written
+        :type value: any supported value type
+        :rtype: None
+        :Example:
+
+        >>> with JsonWriter('data.ndjson', mode='ndjson') as writer:
+        ...     writer.write({'a': 10})
+        ...     writer.write([1, 2])
+        >>> open('data.ndjson','r').read()
+        '{"a":10}\\n[1,2]\\n'
+        """
+        self._writer.write(json_cpp2.JsonParser.__create_descriptor__(value))
+
+    def write_all(self, iterable) -> None:
+        """
+        Writes every value from an iterable to the file
+
+        :param iterable: values to be written
+        :type iterable: iterable
+        :rtype: None
+        :Example:
+
+        >>> with JsonWriter('data.json') as writer:
+        ...     writer.write_all(range(3))
+        >>> open('data.json','r').read()
+        '[0,1,2]'
+        """
+        for value in iterable:
+            self.write(value)
+
+    @property
+    def records(self) -> int:
+        """
+        Number of values written to the file
+        """
+        return self._writer.records
+
+    def flush(self) -> None:
+        self._writer.flush()
+
+    def close(self) -> None:
+        self._writer.close()
+
+    def abort(self) -> None:
+        """
+        Closes the file without terminating the list in 'array' mode, so an interrupted output is not valid json
+        """
+        self._writer.abort()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        if exc_type is None:
+            self.close()
+        else:
+            self.abort()
+
+
+if __name__ == '__main__':
+    import doctest
+    doctest.testmod(optionflags=doctest.ELLIPSIS)
@@ -1,5 +1,6 @@
 #include "../include/json_descriptor.h"
 #include "json_cpp/json_util.h"
+#include <charconv>
 
 using namespace std;
 
@@ -29,12 +30,24 @@ namespace json_cpp {
         value = Json_util::read_int(i);
     }
 
+    void json_write_number(std::ostream &o, double value) {
+        char buffer[32];
+        auto result = to_chars(buffer, buffer + sizeof buffer, value);
+        o.write(buffer, result.ptr - buffer);
+    }
+
+    void json_write_number(std::ostream &o, float value) {
+        char buffer[32];
+        auto result = to_chars(buffer, buffer + sizeof buffer, value);
+        o.write(buffer, result.ptr - buffer);
+    }
+
     void Json_float_descriptor::json_write(std::ostream &o) const {
-        Json_util::write_value(o, value);
+        json_write_number(o, value);
     }
 
     void Json_float_descriptor::json_parse(std::istream &i) {
-        value = (float) Json_util::read_double(i);
+        value = Json_util::read_double(i);
     }
 
     void Json_string_descriptor::json_write(std::ostream &o) const {
@@ -132,14 +145,14 @@ namespace json_cpp {
         }
     }
 
-    void Json_object_descriptor::add_member(const std::string &member_name, Json_descriptor &member_descriptor,
+    void Json_object_descriptor::add_member(const std::string &member_name, const Json_descriptor &member_descriptor,
                                             bool member_mandatory) {
         members_descriptor.values.push_back(member_descriptor.new_item());
         members_name.push_back(member_name);
         members_mandatory.push_back(member_mandatory);
     }
 
-    void Json_object_descriptor::set(const std::string &member_name, Json_descriptor &new_descriptor) {
+    void Json_object_descriptor::set(const std::string &member_name, const Json_descriptor &new_descriptor) {
         int i = find(member_name);
         if (i >= 0) members_descriptor.replace(i, new_descriptor);
         else add_member(member_name, new_descriptor, true);
@@ -171,6 +184,11 @@ namespace json_cpp {
         set(member_name, m);
     }
 
+    void Json_object_descriptor::set(const std::string &member_name, double value) {
+        auto m = Json_float_descriptor(value);
+        set(member_name, m);
+    }
+
     void Json_object_descriptor::set(const std::string &member_name, string value) {
         auto m = Json_string_descriptor(value);
         set(member_name, m);
@@ -182,6 +200,14 @@ namespace json_cpp {
         throw runtime_error("member not found");
     }
 
+    void Json_object_descriptor::remove(const std::string &member_name) {
+        auto i = find(member_name);
+        if (i < 0) throw runtime_error("member not found");
+        members_descriptor.values.erase(members_descriptor.values.begin() + i);
+        members_name.erase(members_name.begin() + i);
+        members_mandatory.erase(members_mandatory.begin() + i);
+    }
+
     void Json_list_descriptor::json_parse(std::istream &i) {
         if (!item_descriptor) {
             item_descriptor = make_unique<Json_variant_descriptor>();
@@ -312,4 +338,17 @@ namespace json_cpp {
 
     void Json_variant_descriptor::clear() {
     }
+
+    const Json_descriptor &json_resolve(const Json_descriptor &descriptor) {
+        auto resolved = &descriptor;
+        while (auto variant = dynamic_cast<const Json_variant_descriptor *>(resolved)) {
+            if (!variant->value) break;
+            resolved = variant->value.get();
+        }
+        return *resolved;
+    }
+
+    Json_descriptor &json_resolve(Json_descriptor &descriptor) {
+        return const_cast<Json_descriptor &>(json_resolve((const Json_descriptor &) descriptor));
+    }
 }
\ No newline at end of file
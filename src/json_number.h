@@ -0,0 +1,18 @@
+#pragma once
+#include "../include/json_descriptor.h"
+
+// numeric helpers shared by the patch and query operators. ints and floats compare by value.
+
+namespace json_cpp {
+    namespace json_number {
+
+        inline bool is_number(Json_descriptor::Json_descriptor_type t) {
+            return t == Json_descriptor::Json_descriptor_type::Int || t == Json_descriptor::Json_descriptor_type::Float;
+        }
+
+        inline double number_value(const Json_descriptor &d) {
+            if (d.get_type() == Json_descriptor::Json_descriptor_type::Int) return dynamic_cast<const Json_int_descriptor &>(d).value;
+            return dynamic_cast<const Json_float_descriptor &>(d).value;
+        }
+    }
+}
@@ -0,0 +1,427 @@
+#include "../include/json_patch.h"
+#include "json_number.h"
+#include <unordered_map>
+#include <string_view>
+
+using namespace std;
+
+namespace json_cpp {
+
+    namespace {
+
+        using Json_descriptor_type = Json_descriptor::Json_descriptor_type;
+
+        using json_number::is_number;
+        using json_number::number_value;
+
+        // hashed member lookup for large objects, names are not copied
+        struct Member_index {
+            explicit Member_index(const Json_object_descriptor &o) : object(o) {
+                if (o.members_name.size() <= 8) return;
+                index.reserve(o.members_name.size());
+                for (size_t i = 0; i < o.members_name.size(); i++) index.emplace(o.members_name[i], i);
+            }
+            int find(const string &name) const {
+                if (index.empty()) {
+                    for (size_t i = 0; i < object.members_name.size(); i++) {
+                        if (object.members_name[i] == name) return (int) i;
+                    }
+                    return -1;
+                }
+                auto i = index.find(name);
+                return i == index.end() ? -1 : (int) i->second;
+            }
+            const Json_object_descriptor &object;
+            unordered_map<string_view, size_t> index;
+        };
+
+        string escape(const string &token) {
+            string escaped;
+            for (char c: token) {
+                if (c == '~') escaped += "~0";
+                else if (c == '/') escaped += "~1";
+                else escaped += c;
+            }
+            return escaped;
+        }
+
+        void add_member(Json_object_descriptor &o, const string &name, Json_descriptor_ptr value) {
+            o.members_name.push_back(name);
+            o.members_descriptor.values.push_back(std::move(value));
+            o.members_mandatory.push_back(true);
+        }
+
+        // members added by a patch are optional, the patched object still parses input without them
+        void set_member(Json_object_descriptor &o, const string &name, const Json_descriptor &value) {
+            auto i = o.find(name);
+            if (i >= 0) o.members_descriptor.replace(i, value);
+            else o.add_member(name, value, false);
+        }
+
+        struct Json_differ {
+            unique_ptr<Json_list_descriptor> patch = make_unique<Json_list_descriptor>();
+
+            void operation(const string &op, const string &path, const Json_descriptor *value) {
+                auto o = make_unique<Json_object_descriptor>();
+                o->set("op", op);
+                o->set("path", path);
+                if (value) o->add_member("value", *value, true);
+                patch->value.values.push_back(std::move(o));
+            }
+
+            void compare(const Json_descriptor &a, const Json_descriptor &b, const string &path) {
+                auto &x = json_resolve(a);
+                auto &y = json_resolve(b);
+                if (&x == &y) return;
+                auto ox = dynamic_cast<const Json_object_descriptor *>(&x);
+                auto oy = dynamic_cast<const Json_object_descriptor *>(&y);
+                if (ox && oy) {
+                    compare_objects(*ox, *oy, path);
+                    return;
+                }
+                auto lx = dynamic_cast<const Json_list_descriptor *>(&x);
+                auto ly = dynamic_cast<const Json_list_descriptor *>(&y);
+                if (lx && ly) {
+                    compare_lists(lx->value.values, ly->value.values, path);
+                    return;
+                }
+                if (!json_equal(x, y)) operation("replace", path, &y);
+            }
+
+            void compare_objects(const Json_object_descriptor &x, const Json_object_descriptor &y, const string &path) {
+                Member_index x_index(x);
+                Member_index y_index(y);
+                for (auto &name: x.members_name) {
+                    if (y_index.find(name) < 0) operation("remove", path + "/" + escape(name), nullptr);
+                }
+                for (size_t j = 0; j < y.members_name.size(); j++) {
+                    auto &name = y.members_name[j];
+                    auto i = x_index.find(name);
+                    if (i < 0) operation("add", path + "/" + escape(name), &json_resolve(*y.members_descriptor.values[j]));
+                    else compare(*x.members_descriptor.values[i], *y.members_descriptor.values[j], path + "/" + escape(name));
+                }
+            }
+
+            void compare_lists(const vector<Json_descriptor_ptr> &x, const vector<Json_descriptor_ptr> &y, const string &path) {
+                size_t common = min(x.size(), y.size());
+                size_t prefix = 0;
+                while (prefix < common && json_equal(*x[prefix], *y[prefix])) prefix++;
+                size_t suffix = 0;
+                while (suffix < common - prefix && json_equal(*x[x.size() - 1 - suffix], *y[y.size() - 1 - suffix])) suffix++;
+                size_t x_size = x.size() - prefix - suffix;
+                size_t y_size = y.size() - prefix - suffix;
+                size_t changed = min(x_size, y_size);
+                for (size_t k = prefix; k < prefix + changed; k++) {
+                    compare(*x[k], *y[k], path + "/" + to_string(k));
+                }
+                for (size_t k = y_size; k < x_size; k++) {
+                    operation("remove", path + "/" + to_string(prefix + changed), nullptr);
+                }
+                for (size_t k = x_size; k < y_size; k++) {
+                    operation("add", path + "/" + to_string(prefix + k), &json_resolve(*y[prefix + k]));
+                }
+            }
+        };
+
+        vector<string> split(const string &path) {
+            vector<string> tokens;
+            if (path.empty()) return tokens;
+            if (path[0] != '/') throw logic_error("invalid json pointer " + path);
+            string token;
+            for (size_t i = 1; i <= path.size(); i++) {
+                if (i == path.size() || path[i] == '/') {
+                    tokens.push_back(token);
+                    token.clear();
+                } else if (path[i] == '~' && i + 1 < path.size() && (path[i + 1] == '0' || path[i + 1] == '1')) {
+                    token += path[++i] == '0' ? '~' : '/';
+                } else {
+                    token += path[i];
+                }
+            }
+            return tokens;
+        }
+
+        size_t list_index(const string &token, size_t size, bool allow_end) {
+            if (token.empty() || (token.size() > 1 && token[0] == '0') || token.find_first_not_of("0123456789") != string::npos)
+                throw logic_error("invalid list index " + token);
+            size_t index = stoul(token);
+            if (index > size || (index == size && !allow_end)) throw runtime_error("index not found.");
+            return index;
+        }
+
+        Json_descriptor &child(Json_descriptor &node, const string &token) {
+            auto &n = json_resolve(node);
+            if (auto o = dynamic_cast<Json_object_descriptor *>(&n)) return o->get(token);
+            if (auto l = dynamic_cast<Json_list_descriptor *>(&n)) return *l->value.values[list_index(token, l->value.values.size(), false)];
+            throw runtime_error("path not found: " + token);
+        }
+
+        Json_descriptor &locate(Json_descriptor &doc, const vector<string> &tokens, size_t count) {
+            Json_descriptor *node = &doc;
+            for (size_t i = 0; i < count; i++) node = &child(*node, tokens[i]);
+            return *node;
+        }
+
+        // replaces the content of a descriptor that cannot be swapped by its parent (the root)
+        void assign(Json_descriptor &target, const Json_descriptor &value) {
+            auto &source = json_resolve(value);
+            if (auto v = dynamic_cast<Json_variant_descriptor *>(&target)) {
+                v->value = source.new_item();
+                return;
+            }
+            if (target.get_type() != source.get_type()) throw logic_error("cannot replace a value with a value of a different type");
+            if (auto t = dynamic_cast<Json_bool_descriptor *>(&target)) t->value = dynamic_cast<const Json_bool_descriptor &>(source).value;
+            else if (auto t = dynamic_cast<Json_int_descriptor *>(&target)) t->value = dynamic_cast<const Json_int_descriptor &>(source).value;
+            else if (auto t = dynamic_cast<Json_float_descriptor *>(&target)) t->value = dynamic_cast<const Json_float_descriptor &>(source).value;
+            else if (auto t = dynamic_cast<Json_string_descriptor *>(&target)) t->value = dynamic_cast<const Json_string_descriptor &>(source).value;
+            else if (auto t = dynamic_cast<Json_object_descriptor *>(&target)) *t = dynamic_cast<const Json_object_descriptor &>(source);
+            else if (auto t = dynamic_cast<Json_list_descriptor *>(&target)) t->value = dynamic_cast<const Json_list_descriptor &>(source).value;
+            else if (target.get_type() != Json_descriptor_type::Null) throw logic_error("cannot replace value");
+        }
+
+        void add(Json_descriptor &doc, const vector<string> &tokens, const Json_descriptor &value) {
+            if (tokens.empty()) {
+                assign(doc, value);
+                return;
+            }
+            auto &parent = json_resolve(locate(doc, tokens, tokens.size() - 1));
+            auto &token = tokens.back();
+            if (auto o = dynamic_cast<Json_object_descriptor *>(&parent)) {
+                set_member(*o, token, json_resolve(value));
+                return;
+            }
+            if (auto l = dynamic_cast<Json_list_descriptor *>(&parent)) {
+                auto &values = l->value.values;
+                size_t index = token == "-" ? values.size() : list_index(token, values.size(), true);
+                values.insert(values.begin() + (long) index, json_resolve(value).new_item());
+                return;
+            }
+            throw runtime_error("path not found: " + token);
+        }
+
+        // a value taken out of its parent, with its position so it can be put back
+        struct Removed_value {
+            Json_descriptor_ptr value;
+            size_t position;
+            bool mandatory;
+        };
+
+        Removed_value remove(Json_descriptor &doc, const vector<string> &tokens) {
+            if (tokens.empty()) throw logic_error("cannot remove the root");
+            auto &parent = json_resolve(locate(doc, tokens, tokens.size() - 1));
+            auto &token = tokens.back();
+            if (auto o = dynamic_cast<Json_object_descriptor *>(&parent)) {
+                auto i = o->find(token);
+                if (i < 0) throw runtime_error("member not found");
+                Removed_value removed{std::move(o->members_descriptor.values[i]), (size_t) i, (bool) o->members_mandatory[i]};
+                o->remove(token);
+                return removed;
+            }
+            if (auto l = dynamic_cast<Json_list_descriptor *>(&parent)) {
+                auto &values = l->value.values;
+                size_t index = list_index(token, values.size(), false);
+                Removed_value removed{std::move(values[index]), index, false};
+                values.erase(values.begin() + (long) index);
+                return removed;
+            }
+            throw runtime_error("path not found: " + token);
+        }
+
+        // undoes a remove, the parent is unchanged since
+        void restore(Json_descriptor &doc, const vector<string> &tokens, Removed_value removed) {
+            auto &parent = json_resolve(locate(doc, tokens, tokens.size() - 1));
+            auto position = (long) removed.position;
+            if (auto o = dynamic_cast<Json_object_descriptor *>(&parent)) {
+                o->members_name.insert(o->members_name.begin() + position, tokens.back());
+                o->members_descriptor.values.insert(o->members_descriptor.values.begin() + position, std::move(removed.value));
+                o->members_mandatory.insert(o->members_mandatory.begin() + position, removed.mandatory);
+                return;
+            }
+            auto &values = dynamic_cast<Json_list_descriptor &>(parent).value.values;
+            values.insert(values.begin() + position, std::move(removed.value));
+        }
+
+        void replace(Json_descriptor &doc, const vector<string> &tokens, const Json_descriptor &value) {
+            if (tokens.empty()) {
+                assign(doc, value);
+                return;
+            }
+            auto &parent = json_resolve(locate(doc, tokens, tokens.size() - 1));
+            auto &token = tokens.back();
+            if (auto o = dynamic_cast<Json_object_descriptor *>(&parent)) {
+                auto i = o->find(token);
+                if (i < 0) throw runtime_error("member not found");
+                o->members_descriptor.replace(i, json_resolve(value));
+                return;
+            }
+            if (auto l = dynamic_cast<Json_list_descriptor *>(&parent)) {
+                l->value.replace(list_index(token, l->value.values.size(), false), json_resolve(value));
+                return;
+            }
+            throw runtime_error("path not found: " + token);
+        }
+
+        const Json_descriptor &operation_member(const Json_object_descriptor &o, const string &name) {
+            for (size_t i = 0; i < o.members_name.size(); i++) {
+                if (o.members_name[i] == name) return json_resolve(*o.members_descriptor.values[i]);
+            }
+            throw logic_error("json patch operation is missing '" + name + "'");
+        }
+
+        const string &operation_string(const Json_object_descriptor &o, const string &name) {
+            auto s = dynamic_cast<const Json_string_descriptor *>(&operation_member(o, name));
+            if (!s) throw logic_error("json patch operation '" + name + "' must be a string");
+            return s->value;
+        }
+    }
+
+    bool json_equal(const Json_descriptor &a, const Json_descriptor &b) {
+        auto &x = json_resolve(a);
+        auto &y = json_resolve(b);
+        if (&x == &y) return true;
+        auto x_type = x.get_type();
+        auto y_type = y.get_type();
+        if (is_number(x_type) && is_number(y_type)) return number_value(x) == number_value(y);
+        if (x_type != y_type) return false;
+        switch (x_type) {
+            case Json_descriptor_type::Null:
+                return true;
+            case Json_descriptor_type::Bool:
+                return dynamic_cast<const Json_bool_descriptor &>(x).value == dynamic_cast<const Json_bool_descriptor &>(y).value;
+            case Json_descriptor_type::String:
+                return dynamic_cast<const Json_string_descriptor &>(x).value == dynamic_cast<const Json_string_descriptor &>(y).value;
+            default:
+                break;
+        }
+        auto ox = dynamic_cast<const Json_object_descriptor *>(&x);
+        auto oy = dynamic_cast<const Json_object_descriptor *>(&y);
+        if (ox && oy) {
+            if (ox->members_name.size() != oy->members_name.size()) return false;
+            Member_index y_index(*oy);
+            for (size_t i = 0; i < ox->members_name.size(); i++) {
+                auto j = y_index.find(ox->members_name[i]);
+                if (j < 0 || !json_equal(*ox->members_descriptor.values[i], *oy->members_descriptor.values[j])) return false;
+            }
+            return true;
+        }
+        auto lx = dynamic_cast<const Json_list_descriptor *>(&x);
+        auto ly = dynamic_cast<const Json_list_descriptor *>(&y);
+        if (lx && ly) {
+            if (lx->value.values.size() != ly->value.values.size()) return false;
+            for (size_t i = 0; i < lx->value.values.size(); i++) {
+                if (!json_equal(*lx->value.values[i], *ly->value.values[i])) return false;
+            }
+            return true;
+        }
+        return x.to_json() == y.to_json();
+    }
+
+    Json_descriptor_ptr diff(const Json_descriptor &a, const Json_descriptor &b) {
+        Json_differ differ;
+        differ.compare(a, b, "");
+        return std::move(differ.patch);
+    }
+
+    Json_descriptor_ptr merge_diff(const Json_descriptor &a, const Json_descriptor &b) {
+        auto &x = json_resolve(a);
+        auto &y = json_resolve(b);
+        auto ox = dynamic_cast<const Json_object_descriptor *>(&x);
+        auto oy = dynamic_cast<const Json_object_descriptor *>(&y);
+        if (!ox || !oy) return y.new_item();
+        auto patch = make_unique<Json_object_descriptor>();
+        Member_index x_index(*ox);
+        Member_index y_index(*oy);
+        for (auto &name: ox->members_name) {
+            if (y_index.find(name) < 0) add_member(*patch, name, make_unique<Json_null_descriptor>());
+        }
+        for (size_t j = 0; j < oy->members_name.size(); j++) {
+            auto &name = oy->members_name[j];
+            auto &y_value = json_resolve(*oy->members_descriptor.values[j]);
+            auto i = x_index.find(name);
+            if (i < 0) {
+                add_member(*patch, name, y_value.new_item());
+                continue;
+            }
+            auto &x_value = json_resolve(*ox->members_descriptor.values[i]);
+            if (dynamic_cast<const Json_object_descriptor *>(&x_value) && dynamic_cast<const Json_object_descriptor *>(&y_value)) {
+                auto member_patch = merge_diff(x_value, y_value);
+                if (!static_cast<Json_object_descriptor &>(*member_patch).members_name.empty())
+                    add_member(*patch, name, std::move(member_patch));
+            } else if (!json_equal(x_value, y_value)) {
+                add_member(*patch, name, y_value.new_item());
+            }
+        }
+        return patch;
+    }
+
+    void apply_patch(Json_descriptor &doc, const Json_descriptor &patch) {
+        auto operations = dynamic_cast<const Json_list_descriptor *>(&json_resolve(patch));
+        if (!operations) throw logic_error("json patch must be a list of operations");
+        for (auto &item: operations->value.values) {
+            auto o = dynamic_cast<const Json_object_descriptor *>(&json_resolve(*item));
+            if (!o) throw logic_error("json patch operation must be an object");
+            auto &op = operation_string(*o, "op");
+            auto path = split(operation_string(*o, "path"));
+            if (op == "add") {
+                add(doc, path, operation_member(*o, "value"));
+            } else if (op == "remove") {
+                remove(doc, path);
+            } else if (op == "replace") {
+                replace(doc, path, operation_member(*o, "value"));
+            } else if (op == "move") {
+                auto &from_path = operation_string(*o, "from");
+                auto &to_path = operation_string(*o, "path");
+                if (to_path.compare(0, from_path.size() + 1, from_path + "/") == 0)
+                    throw logic_error("cannot move a value into one of its children");
+                auto from = split(from_path);
+                auto removed = remove(doc, from);
+                try {
+                    add(doc, path, *removed.value);
+                } catch (...) {
+                    // a failed move leaves the document as it was
+                    restore(doc, from, std::move(removed));
+                    throw;
+                }
+            } else if (op == "copy") {
+                auto from = split(operation_string(*o, "from"));
+                auto value = json_resolve(locate(doc, from, from.size())).new_item();
+                add(doc, path, *value);
+            } else if (op == "test") {
+                if (!json_equal(locate(doc, path, path.size()), operation_member(*o, "value")))
+                    throw runtime_error("json patch test failed at " + operation_string(*o, "path"));
+            } else {
+                throw logic_error("unknown json patch operation " + op);
+            }
+        }
+    }
+
+    void apply_merge_patch(Json_descriptor &doc, const Json_descriptor &patch) {
+        auto &p = json_resolve(patch);
+        auto po = dynamic_cast<const Json_object_descriptor *>(&p);
+        if (!po) {
+            assign(doc, p);
+            return;
+        }
+        auto o = dynamic_cast<Json_object_descriptor *>(&json_resolve(doc));
+        if (!o) {
+            assign(doc, Json_object_descriptor());
+            o = dynamic_cast<Json_object_descriptor *>(&json_resolve(doc));
+        }
+        for (size_t i = 0; i < po->members_name.size(); i++) {
+            auto &name = po->members_name[i];
+            auto &value = json_resolve(*po->members_descriptor.values[i]);
+            if (value.get_type() == Json_descriptor_type::Null) {
+                if (o->contains(name)) o->remove(name);
+            } else if (dynamic_cast<const Json_object_descriptor *>(&value)) {
+                auto m = o->find(name);
+                if (m < 0 || !dynamic_cast<Json_object_descriptor *>(&json_resolve(*o->members_descriptor.values[m]))) {
+                    set_member(*o, name, Json_object_descriptor());
+                    m = o->find(name);
+                }
+                apply_merge_patch(*o->members_descriptor.values[m], value);
+            } else {
+                set_member(*o, name, value);
+            }
+        }
+    }
+}
@@ -1,10 +1,142 @@
 #include "../include/json_descriptor.h"
+#include "../include/json_validator.h"
+#include "../include/json_writer.h"
+#include "../include/json_patch.h"
+#include "../include/json_query.h"
+#include "../include/json_shared.h"
 #include <pybind11/pybind11.h>
 #include <map>
+#include <stdexcept>
+#include <climits>
 
 using namespace json_cpp;
 using namespace std;
 
+// points to the utf-8 content of a python str or bytes without copying it.
+// the buffer is only valid while the python object is alive.
+static pair<const char *, size_t> buffer_view(const pybind11::handle &h) {
+    Py_ssize_t size;
+    if (PyBytes_Check(h.ptr())) {
+        char *data;
+        if (PyBytes_AsStringAndSize(h.ptr(), &data, &size)) throw pybind11::error_already_set();
+        return {data, (size_t) size};
+    }
+    const char *data = PyUnicode_AsUTF8AndSize(h.ptr(), &size);
+    if (!data) throw pybind11::error_already_set();
+    return {data, (size_t) size};
+}
+
+// values read from a shared document hold a reference to the python document, so the mapping
+// stays attached while any of them is alive.
+struct Python_shared_value {
+    Json_shared_value value;
+    pybind11::object document;
+};
+
+// scalars are returned as python values, lists and objects as views
+static pybind11::object shared_value_to_python(const Json_shared_value &value, const pybind11::object &document) {
+    switch (value.get_type()) {
+        case Json_descriptor::Json_descriptor_type::Bool:
+            return pybind11::bool_(value.get_bool());
+        case Json_descriptor::Json_descriptor_type::Int:
+            return pybind11::int_(value.get_int());
+        case Json_descriptor::Json_descriptor_type::Float:
+            return pybind11::float_(value.get_float());
+        case Json_descriptor::Json_descriptor_type::String: {
+            auto s = value.get_string();
+            return pybind11::str(s.data(), s.size());
+        }
+        case Json_descriptor::Json_descriptor_type::List:
+        case Json_descriptor::Json_descriptor_type::Object:
+            return pybind11::cast(Python_shared_value{value, document});
+        default:
+            return pybind11::none();
+    }
+}
+
+// iterates a view without copying it: items of lists, keys of objects, read one at a time
+struct Python_shared_iterator {
+    Python_shared_value view;
+    size_t index{0};
+};
+
+static pybind11::object shared_member(const Python_shared_value &v, const string &name) {
+    auto member = v.value;
+    if (v.value.get_type() != Json_descriptor::Json_descriptor_type::Object || !v.value.find(name, member))
+        throw pybind11::key_error(name);
+    return shared_value_to_python(member, v.document);
+}
+
+static pybind11::list shared_keys(const Python_shared_value &v) {
+    pybind11::list keys;
+    for (size_t i = 0; i < v.value.size(); i++) {
+        auto key = v.value.key(i);
+        keys.append(pybind11::str(key.data(), key.size()));
+    }
+    return keys;
+}
+
+// descriptor of a python value built in a single native pass, read by the queries. only the values are
+// converted: json objects by their public members as JsonObject.keys() lists them, other parsable types
+// through their own descriptor. ints that do not fit Json_int_descriptor are rejected.
+static Json_descriptor_ptr python_descriptor(const pybind11::handle &value, const pybind11::handle &json_object) {
+    auto p = value.ptr();
+    if (value.is_none()) return make_unique<Json_null_descriptor>();
+    if (PyBool_Check(p)) return make_unique<Json_bool_descriptor>(p == Py_True);
+    if (PyLong_Check(p)) {
+        int overflow;
+        auto i = PyLong_AsLongLongAndOverflow(p, &overflow);
+        if (overflow || i < INT_MIN || i > INT_MAX) throw overflow_error("int out of range");
+        return make_unique<Json_int_descriptor>((int) i);
+    }
+    if (PyFloat_Check(p)) return make_unique<Json_float_descriptor>(PyFloat_AS_DOUBLE(p));
+    if (PyUnicode_Check(p)) return make_unique<Json_string_descriptor>(value.cast<string>());
+    if (PyList_Check(p) || PyTuple_Check(p)) {
+        auto list = make_unique<Json_list_descriptor>();
+        for (auto item: value) list->value.values.push_back(python_descriptor(item, json_object));
+        return list;
+    }
+    bool is_dict = PyDict_Check(p);
+    if (is_dict || pybind11::isinstance(value, json_object)) {
+        auto object = make_unique<Json_object_descriptor>();
+        auto members = is_dict ? pybind11::reinterpret_borrow<pybind11::dict>(value) : pybind11::dict(value.attr("__dict__"));
+        for (auto member: members) {
+            auto name = pybind11::str(member.first).cast<string>();
+            if (!is_dict && (name.empty() || name[0] == '_')) continue;
+            object->members_name.push_back(name);
+            object->members_descriptor.values.push_back(python_descriptor(member.second, json_object));
+            object->members_mandatory.push_back(false);
+        }
+        return object;
+    }
+    if (!pybind11::hasattr(value, "__get_descriptor__"))
+        throw pybind11::type_error("type " + pybind11::str(value.attr("__class__")).cast<string>() + " not supported by json-cpp");
+    return value.attr("__get_descriptor__")().cast<const Json_descriptor &>().new_item();
+}
+
+// members at a dotted path of every item, the python values themselves. missing members are None
+static pybind11::list member_values(const pybind11::list &items, const string &path) {
+    vector<pybind11::str> tokens;
+    for (size_t start = 0, end = 0; end != string::npos; start = end + 1) {
+        end = path.find('.', start);
+        tokens.emplace_back(path.substr(start, end - start));
+    }
+    pybind11::list values;
+    for (auto item: items) {
+        pybind11::object node = pybind11::reinterpret_borrow<pybind11::object>(item);
+        for (auto &token: tokens) {
+            if (node.is_none()) break;
+            if (PyDict_Check(node.ptr())) {
+                auto d = pybind11::reinterpret_borrow<pybind11::dict>(node);
+                node = d.contains(token) ? pybind11::object(d[token]) : pybind11::none();
+            } else {
+                node = pybind11::getattr(node, token, pybind11::none());
+            }
+        }
+        values.append(node);
+    }
+    return values;
+}
 
 PYBIND11_MODULE(json_cpp2_core, m) {
     pybind11::class_<Json_descriptor>(m, "JsonDescriptor");
@@ -119,7 +251,7 @@ PYBIND11_MODULE(json_cpp2_core, m) {
     m.def("get_descriptor",[](int i){
         return Json_int_descriptor(i);
     });
-    m.def("get_descriptor",[](float f){
+    m.def("get_descriptor",[](double f){
         return Json_float_descriptor(f);
     });
     m.def("get_descriptor",[](string &s){
@@ -151,4 +283,209 @@ PYBIND11_MODULE(json_cpp2_core, m) {
                 return m.value.values.size();
             })
             ;
+
+    pybind11::class_<Json_validation_result>(m, "JsonValidationResult")
+            .def_readonly("valid", &Json_validation_result::valid)
+            .def_readonly("path", &Json_validation_result::path)
+            .def_readonly("offset", &Json_validation_result::offset)
+            .def_readonly("reason", &Json_validation_result::reason)
+            .def("__bool__", [](const Json_validation_result &r){
+                return r.valid;
+            })
+            .def("__repr__", [](const Json_validation_result &r){
+                if (r.valid) return string("valid");
+                return r.reason + " at '" + r.path + "' (offset " + to_string(r.offset) + ")";
+            })
+            ;
+
+    m.def("validate",[](const Json_descriptor &schema, const pybind11::object &buffer){
+        auto view = buffer_view(buffer);
+        pybind11::gil_scoped_release release;
+        return validate(schema, view.first, view.second);
+    });
+    m.def("validate_batch",[](const Json_descriptor &schema, const pybind11::iterable &buffers){
+        vector<pybind11::object> items;
+        vector<pair<const char *, size_t>> views;
+        for (auto buffer: buffers) {
+            views.push_back(buffer_view(buffer));
+            items.push_back(pybind11::reinterpret_borrow<pybind11::object>(buffer));
+        }
+        vector<Json_validation_result> results(views.size());
+        {
+            pybind11::gil_scoped_release release;
+            for (size_t i = 0; i < views.size(); i++)
+                results[i] = validate(schema, views[i].first, views[i].second);
+        }
+        pybind11::list l;
+        for (auto &r: results) l.append(pybind11::cast(r));
+        return l;
+    });
+
+    // Json_writer is not synchronized: its methods keep the GIL so python threads sharing a writer don't race on the buffer
+    pybind11::class_<Json_writer>(m, "JsonWriter")
+            .def(pybind11::init([](const string &file_path, const string &mode, size_t buffer_size, bool background){
+                Json_writer::Json_writer_mode writer_mode;
+                if (mode == "array") writer_mode = Json_writer::Json_writer_mode::Array;
+                else if (mode == "ndjson") writer_mode = Json_writer::Json_writer_mode::Ndjson;
+                else if (mode == "value") writer_mode = Json_writer::Json_writer_mode::Value;
+                else throw pybind11::value_error("mode must be 'array', 'ndjson' or 'value'");
+                return new Json_writer(file_path, writer_mode, buffer_size, background);
+            }), pybind11::arg("file_path"), pybind11::arg("mode") = "array", pybind11::arg("buffer_size") = 1 << 16, pybind11::arg("background") = false)
+            .def("write", +[](Json_writer &w, const Json_descriptor &d){
+                w.write(d);
+            })
+            .def("write_json", +[](Json_writer &w, const string &json){
+                w.write(json);
+            })
+            .def("flush", &Json_writer::flush)
+            .def("close", &Json_writer::close)
+            .def("abort", &Json_writer::abort)
+            .def("is_open", &Json_writer::is_open)
+            .def_readonly("records", &Json_writer::records)
+            ;
+
+    m.def("json_equal", &json_equal, pybind11::call_guard<pybind11::gil_scoped_release>());
+    m.def("diff", &diff, pybind11::call_guard<pybind11::gil_scoped_release>());
+    m.def("merge_diff", &merge_diff, pybind11::call_guard<pybind11::gil_scoped_release>());
+    // the document is patched inside a variant, so the patch can replace the root by a value of another type.
+    // returns the patched document
+    m.def("apply_patch", [](const Json_descriptor &doc, const Json_descriptor &patch){
+        Json_variant_descriptor root;
+        root.value = doc.new_item();
+        apply_patch(root, patch);
+        return std::move(root.value);
+    }, pybind11::call_guard<pybind11::gil_scoped_release>());
+    m.def("apply_merge_patch", [](const Json_descriptor &doc, const Json_descriptor &patch){
+        Json_variant_descriptor root;
+        root.value = doc.new_item();
+        apply_merge_patch(root, patch);
+        return std::move(root.value);
+    }, pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    pybind11::class_<Json_query_aggregate>(m, "JsonQueryAggregate")
+            .def_readonly("count", &Json_query_aggregate::count)
+            .def_readonly("integer", &Json_query_aggregate::integer)
+            .def_readonly("integer_sum", &Json_query_aggregate::integer_sum)
+            .def_readonly("sum", &Json_query_aggregate::sum)
+            .def_readonly("min", &Json_query_aggregate::min)
+            .def_readonly("max", &Json_query_aggregate::max)
+            ;
+
+    m.def("where_indices",[](const Json_list_descriptor &list, const string &path, const string &op, const Json_descriptor &value){
+        auto query_operator = get_query_operator(op);
+        vector<size_t> indices;
+        {
+            pybind11::gil_scoped_release release;
+            indices = where_indices(list, path, query_operator, value);
+        }
+        pybind11::list l;
+        for (auto i: indices) l.append(i);
+        return l;
+    });
+    m.def("where",[](const Json_list_descriptor &list, const string &path, const string &op, const Json_descriptor &value){
+        auto query_operator = get_query_operator(op);
+        pybind11::gil_scoped_release release;
+        return where(list, path, query_operator, value);
+    });
+    m.def("select_members",[](const Json_list_descriptor &list, const pybind11::iterable &members){
+        vector<string> names;
+        for (auto member: members) names.push_back(member.cast<string>());
+        pybind11::gil_scoped_release release;
+        return select_members(list, names);
+    });
+    m.def("column", &column, pybind11::call_guard<pybind11::gil_scoped_release>());
+    m.def("create_descriptor", [](const pybind11::handle &value){
+        return python_descriptor(value, pybind11::module_::import("json_cpp2").attr("JsonObject"));
+    });
+    m.def("member_values", &member_values);
+    m.def("aggregate", &aggregate, pybind11::call_guard<pybind11::gil_scoped_release>());
+    m.def("group_by_indices",[](const Json_list_descriptor &list, const string &path){
+        vector<Json_query_group> groups;
+        {
+            pybind11::gil_scoped_release release;
+            groups = group_by_indices(list, path);
+        }
+        pybind11::list l;
+        for (auto &group: groups) {
+            pybind11::list indices;
+            for (auto i: group.indices) indices.append(i);
+            l.append(pybind11::make_tuple(pybind11::cast(std::move(group.key)), indices));
+        }
+        return l;
+    });
+    m.def("group_by", &group_by, pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    pybind11::class_<Python_shared_value>(m, "JsonSharedValue")
+            .def("__len__", [](const Python_shared_value &v){
+                return v.value.size();
+            })
+            .def("__getitem__", [](const Python_shared_value &v, long long index){
+                if (v.value.get_type() != Json_descriptor::Json_descriptor_type::List) throw pybind11::type_error("indices can only be used on lists");
+                auto size = (long long) v.value.size();
+                if (index < 0) index += size;
+                if (index < 0 || index >= size) throw pybind11::index_error("list index out of range");
+                return shared_value_to_python(v.value[(size_t) index], v.document);
+            })
+            .def("__getitem__", &shared_member)
+            // only called when no attribute of the view matches: members named keys, to_json or
+            // to_descriptor are shadowed by the methods and must be read with []
+            .def("__getattr__", [](const Python_shared_value &v, const string &name){
+                try {
+                    return shared_member(v, name);
+                } catch (pybind11::key_error &) {
+                    throw pybind11::attribute_error(name);
+                }
+            })
+            .def("__contains__", [](const Python_shared_value &v, const string &name){
+                return v.value.get_type() == Json_descriptor::Json_descriptor_type::Object && v.value.contains(name);
+            })
+            // like dicts, objects iterate over their keys
+            .def("__iter__", [](const Python_shared_value &v){
+                return Python_shared_iterator{v};
+            })
+            .def("keys", &shared_keys)
+            .def("to_descriptor", [](const Python_shared_value &v){
+                return v.value.to_descriptor();
+            })
+            .def("to_json", [](const Python_shared_value &v){
+                return v.value.to_json();
+            })
+            .def("__str__", [](const Python_shared_value &v){
+                return v.value.to_json();
+            })
+            .def("__repr__", [](const Python_shared_value &v){
+                return v.value.to_json();
+            })
+            ;
+
+    pybind11::class_<Python_shared_iterator>(m, "JsonSharedIterator")
+            .def("__iter__", [](const pybind11::object &self){
+                return self;
+            })
+            .def("__next__", [](Python_shared_iterator &i){
+                auto &v = i.view.value;
+                if (i.index >= v.size()) throw pybind11::stop_iteration();
+                auto index = i.index++;
+                if (v.get_type() == Json_descriptor::Json_descriptor_type::Object) {
+                    auto key = v.key(index);
+                    return pybind11::object(pybind11::str(key.data(), key.size()));
+                }
+                return shared_value_to_python(v[index], i.view.document);
+            })
+            ;
+
+    pybind11::class_<Json_shared_document>(m, "JsonSharedDocument")
+            .def_static("create", &Json_shared_document::create, pybind11::call_guard<pybind11::gil_scoped_release>())
+            .def_static("attach", &Json_shared_document::attach, pybind11::call_guard<pybind11::gil_scoped_release>())
+            .def_static("unlink", &Json_shared_document::unlink)
+            .def_static("create_file", &Json_shared_document::create_file, pybind11::call_guard<pybind11::gil_scoped_release>())
+            .def_static("attach_file", &Json_shared_document::attach_file, pybind11::call_guard<pybind11::gil_scoped_release>())
+            .def("root", [](const pybind11::object &self){
+                return shared_value_to_python(self.cast<const Json_shared_document &>().root(), self);
+            })
+            .def("to_json", [](const Json_shared_document &d){
+                return d.root().to_json();
+            })
+            .def_property_readonly("size", &Json_shared_document::size)
+            ;
 }
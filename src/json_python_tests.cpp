@@ -1,7 +1,20 @@
 #include "catch.h"
 #include "../include/json_descriptor.h"
+#include "../include/json_validator.h"
+#include "../include/json_writer.h"
+#include "../include/json_static_descriptor.h"
+#include "../include/json_patch.h"
+#include "../include/json_query.h"
+#include "../include/json_shared.h"
 #include <iostream>
 #include <cstring>
+#include <fstream>
+#include <cstdio>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace json_cpp;
 using namespace std;
@@ -37,6 +50,17 @@ TEST_CASE("Json_float_descriptor"){
     CHECK(v.to_json() == "20.5");
     v.from_json("30.5");
     CHECK(v.to_json() == "30.5");
+    v.from_json("3.141592653589793");
+    CHECK(v.value == 3.141592653589793);
+    CHECK(v.to_json() == "3.141592653589793");
+    v.value = 0.1 + 0.2;
+    CHECK(v.to_json() == "0.30000000000000004");
+    v.value = 1e300;
+    CHECK(v.to_json() == "1e+300");
+    Json_object_descriptor o;
+    o.set("x", 0.1);
+    o.set("y", 0.1f);
+    CHECK(o.to_json() == "{\"x\":0.1,\"y\":0.10000000149011612}");
 }
 
 TEST_CASE("Json_string_descriptor"){
@@ -136,6 +160,399 @@ TEST_CASE("Python_test") {
     cout << jod << endl;
 }
 
+TEST_CASE("validate"){
+    Json_object_descriptor jod;
+    Json_int_descriptor ji;
+    jod.add_member("id", ji, true);
+    Json_string_descriptor js;
+    jod.add_member("name", js, false);
+    Json_list_descriptor jl;
+    Json_float_descriptor jf;
+    jl.set_item_descriptor(jf);
+    jl.allow_null_values = false;
+    Json_object_descriptor inner;
+    inner.add_member("values", jl, true);
+    inner.allow_undefined_members = false;
+    jod.add_member("inner", inner, false);
+    CHECK(validate(jod, "{\"id\":1,\"name\":\"a\",\"extra\":[1,{\"x\":null}]}"));
+    CHECK(validate(jod, " {\"id\" : -5 , \"name\" : null} "));
+    auto r = validate(jod, "{\"name\":\"a\"}");
+    CHECK(!r.valid);
+    CHECK(r.path == "/id");
+    CHECK(r.reason == "mandatory member missing");
+    r = validate(jod, "{\"id\":1.5}");
+    CHECK(!r.valid);
+    CHECK(r.path == "/id");
+    CHECK(r.offset == 6);
+    r = validate(jod, "{\"id\":null}");
+    CHECK(!r.valid);
+    CHECK(r.path == "/id");
+    r = validate(jod, "{\"id\":1,\"inner\":{\"values\":[1,2.5,null]}}");
+    CHECK(!r.valid);
+    CHECK(r.path == "/inner/values/2");
+    CHECK(r.offset == 33);
+    r = validate(jod, "{\"id\":1,\"inner\":{\"values\":[],\"other\":1}}");
+    CHECK(!r.valid);
+    CHECK(r.path == "/inner/other");
+    CHECK(r.reason == "member is not defined");
+    r = validate(jod, "{\"id\":1,\"id\":2}");
+    CHECK(!r.valid);
+    CHECK(r.offset == 8);
+    r = validate(jod, "{\"id\":1} x");
+    CHECK(!r.valid);
+    CHECK(r.offset == 9);
+    CHECK(!validate(jod, "{\"id\":1,\"name\":\"a"));
+    CHECK(!validate(jod, "{\"id\":99999999999}"));
+    Json_variant_descriptor any;
+    CHECK(validate(any, "[1,\"\\u00e9\",{\"a\":[true,false,null]},-0.5e3]"));
+    CHECK(!validate(any, "[1,]"));
+}
+
+TEST_CASE("Json_writer"){
+    Json_object_descriptor jo;
+    Json_int_descriptor ji(5);
+    jo.add_member("a", ji, true);
+    Json_string_descriptor js("text");
+    jo.add_member("b", js, true);
+    auto read_file = [](const string &file_path){
+        ifstream f(file_path);
+        return string((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    };
+    {
+        Json_writer writer("writer_test.json");
+        writer.write(jo);
+        writer.write(ji);
+        writer.write("[1,2]");
+    }
+    CHECK(read_file("writer_test.json") == "[{\"a\":5,\"b\":\"text\"},5,[1,2]]");
+    {
+        Json_writer writer("writer_test.json");
+    }
+    CHECK(read_file("writer_test.json") == "[]");
+    for (bool background : {false, true}) {
+        Json_writer writer("writer_test.json", Json_writer::Json_writer_mode::Ndjson, 7, background);
+        string expected;
+        for (int i = 0; i < 1000; i++) {
+            jo.set("a", i);
+            writer.write(jo);
+            expected += jo.to_json() + "\n";
+        }
+        writer.close();
+        CHECK(writer.records == 1000);
+        CHECK(read_file("writer_test.json") == expected);
+    }
+    {
+        Json_writer writer("writer_test.json");
+        writer.write(ji);
+        writer.abort();
+        CHECK(!writer.is_open());
+    }
+    CHECK(read_file("writer_test.json") == "[5");
+    {
+        Json_writer writer("writer_test.json", Json_writer::Json_writer_mode::Value);
+        writer.write(jo);
+        CHECK_THROWS_AS(writer.write(ji), logic_error);
+        CHECK_THROWS_AS(writer.write("[1,2]"), logic_error);
+        CHECK(writer.records == 1);
+    }
+    CHECK(read_file("writer_test.json") == jo.to_json());
+    remove("writer_test.json");
+}
+
+struct Static_point {
+    int x;
+    int y;
+};
+constexpr char static_point_x[] = "x";
+constexpr char static_point_y[] = "y";
+using Static_point_descriptor = Json_static_object<Static_point,
+        Json_static_member<static_point_x, &Static_point::x>,
+        Json_static_member<static_point_y, &Static_point::y>>;
+template<> struct json_cpp::Json_static_codec<Static_point> : Static_point_descriptor {};
+
+struct Static_record {
+    int64_t id;
+    std::vector<std::string> tags;
+    double score;
+    std::optional<Static_point> location;
+    std::vector<Static_point> path;
+    Json_object_descriptor extra;
+};
+constexpr char static_record_id[] = "id";
+constexpr char static_record_tags[] = "tags";
+constexpr char static_record_score[] = "score";
+constexpr char static_record_location[] = "location";
+constexpr char static_record_path[] = "path";
+constexpr char static_record_extra[] = "extra";
+using Static_record_descriptor = Json_static_object<Static_record,
+        Json_static_member<static_record_id, &Static_record::id>,
+        Json_static_member<static_record_tags, &Static_record::tags, false>,
+        Json_static_member<static_record_score, &Static_record::score, false>,
+        Json_static_member<static_record_location, &Static_record::location, false>,
+        Json_static_member<static_record_path, &Static_record::path, false>,
+        Json_static_member<static_record_extra, &Static_record::extra, false>>;
+
+struct Static_quoted {
+    std::string text;
+};
+constexpr char static_quoted_text[] = "say \"hi\"";
+using Static_quoted_descriptor = Json_static_object<Static_quoted,
+        Json_static_member<static_quoted_text, &Static_quoted::text>>;
+
+TEST_CASE("Json_static_object"){
+    Static_record_descriptor r;
+    r.from_json("{\"id\":9007199254740993,\"tags\":[\"a\",\"b\"],\"other\":[1,{\"z\":2}],\"score\":0.1,\"location\":{\"y\":2,\"x\":1},\"path\":[{\"x\":3,\"y\":4}],\"extra\":{\"k\":true}}");
+    CHECK(r.value.id == 9007199254740993LL);
+    CHECK(r.value.tags.size() == 2);
+    CHECK(r.value.tags[1] == "b");
+    CHECK(r.value.score == 0.1);
+    CHECK(r.value.location.has_value());
+    CHECK(r.value.location->x == 1);
+    CHECK(r.value.path[0].y == 4);
+    CHECK(r.to_json() == "{\"id\":9007199254740993,\"tags\":[\"a\",\"b\"],\"score\":0.1,\"location\":{\"x\":1,\"y\":2},\"path\":[{\"x\":3,\"y\":4}],\"extra\":{\"k\":true}}");
+    r.from_json("{\"id\":-1,\"location\":null}");
+    CHECK(r.value.id == -1);
+    CHECK(!r.value.location.has_value());
+    r.from_json("{\"id\":2,\"tags\":null,\"score\":null,\"extra\":null}");
+    CHECK(r.value.tags.empty());
+    CHECK(r.value.score == 0);
+    CHECK_THROWS(r.from_json("{\"id\":null}"));
+    CHECK_THROWS(r.from_json("{\"tags\":[]}"));
+    CHECK_THROWS(r.from_json("{\"id\":1.5}"));
+    CHECK_THROWS(r.from_json("{\"id\":99999999999999999999}"));
+    r.allow_undefined_members = false;
+    CHECK_THROWS(r.from_json("{\"id\":1,\"other\":1}"));
+
+    Static_point_descriptor p;
+    Json_object_descriptor jo;
+    jo.add_member("point", p, true);
+    jo.from_json("{\"point\":{\"x\":5,\"y\":6}}");
+    CHECK(jo.to_json() == "{\"point\":{\"x\":5,\"y\":6}}");
+    CHECK(dynamic_cast<Static_point_descriptor &>(jo.get("point")).value.x == 5);
+    Json_list_descriptor jl;
+    jl.set_item_descriptor(p);
+    jl.from_json("[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]");
+    CHECK(jl.to_json() == "[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]");
+
+    r.allow_undefined_members = true;
+    CHECK(validate(r, "{\"id\":1,\"tags\":[\"a\"],\"location\":null,\"path\":[{\"x\":3,\"y\":4}],\"other\":{}}"));
+    auto result = validate(r, "{\"id\":1.5}");
+    CHECK(!result);
+    CHECK(result.path == "/id");
+    CHECK(result.offset == 6);
+    CHECK(validate(r, "{\"tags\":[]}").reason == "mandatory member missing");
+    CHECK(validate(r, "{\"id\":null}").path == "/id");
+    CHECK(validate(r, "{\"id\":1,\"path\":[{\"x\":3}]}").path == "/path");
+    CHECK(!validate(r, "{\"id\":1,\"id\":2}"));
+    CHECK(!validate(r, "{\"id\":1,\"score\":\"x\"}"));
+    r.allow_undefined_members = false;
+    CHECK(validate(r, "{\"id\":1,\"other\":1}").reason == "member is not defined");
+    CHECK(!validate(jo, "{\"point\":{\"x\":5}}"));
+    CHECK(validate(jl, "[{\"x\":1,\"y\":2}]"));
+
+    Static_quoted_descriptor q;
+    q.value.text = "v";
+    CHECK(q.to_json() == "{\"say \\\"hi\\\"\":\"v\"}");
+    q.from_json("{\"say \\\"hi\\\"\":\"w\"}");
+    CHECK(q.value.text == "w");
+}
+
+TEST_CASE("json_patch"){
+    Json_variant_descriptor a;
+    a.from_json("{\"a\":1,\"b\":{\"c\":\"x\",\"d\":[1,2,3]},\"e\":true,\"f\":[1,2,3,4]}");
+    Json_variant_descriptor b;
+    b.from_json("{\"a\":1.0,\"b\":{\"c\":\"y\",\"d\":[1,2,3]},\"g\":null,\"f\":[0,1,2,3,4]}");
+    CHECK(json_equal(a, a));
+    CHECK(!json_equal(a, b));
+    auto patch = diff(a, b);
+    CHECK(patch->to_json() == "[{\"op\":\"remove\",\"path\":\"/e\"},{\"op\":\"replace\",\"path\":\"/b/c\",\"value\":\"y\"},{\"op\":\"add\",\"path\":\"/g\",\"value\":null},{\"op\":\"add\",\"path\":\"/f/0\",\"value\":0}]");
+    apply_patch(a, *patch);
+    CHECK(json_equal(a, b));
+    CHECK(diff(a, b)->to_json() == "[]");
+
+    Json_variant_descriptor c;
+    c.from_json("{\"a\":{\"b\":[1,2]},\"c\":1}");
+    Json_variant_descriptor operations;
+    operations.from_json("[{\"op\":\"test\",\"path\":\"/c\",\"value\":1},{\"op\":\"copy\",\"from\":\"/a/b\",\"path\":\"/a/c\"},{\"op\":\"move\",\"from\":\"/a/b\",\"path\":\"/d\"},{\"op\":\"add\",\"path\":\"/d/-\",\"value\":3},{\"op\":\"remove\",\"path\":\"/d/0\"},{\"op\":\"replace\",\"path\":\"/c\",\"value\":\"z\"}]");
+    apply_patch(c, operations);
+    CHECK(c.to_json() == "{\"a\":{\"c\":[1,2]},\"c\":\"z\",\"d\":[2,3]}");
+    operations.from_json("[{\"op\":\"test\",\"path\":\"/c\",\"value\":1}]");
+    CHECK_THROWS(apply_patch(c, operations));
+    operations.from_json("[{\"op\":\"remove\",\"path\":\"/x\"}]");
+    CHECK_THROWS(apply_patch(c, operations));
+    operations.from_json("[{\"op\":\"move\",\"from\":\"/c\",\"path\":\"/x/y\"},{\"op\":\"move\",\"from\":\"/d/0\",\"path\":\"/d/5\"}]");
+    CHECK_THROWS(apply_patch(c, operations));
+    CHECK(c.to_json() == "{\"a\":{\"c\":[1,2]},\"c\":\"z\",\"d\":[2,3]}");
+    operations.from_json("[{\"op\":\"move\",\"from\":\"/d/0\",\"path\":\"/d/5\"}]");
+    CHECK_THROWS(apply_patch(c, operations));
+    CHECK(c.to_json() == "{\"a\":{\"c\":[1,2]},\"c\":\"z\",\"d\":[2,3]}");
+
+    Json_variant_descriptor d;
+    d.from_json("{\"a\":{\"b\":1,\"c\":2},\"d\":[1],\"e\":\"x\"}");
+    Json_variant_descriptor e;
+    e.from_json("{\"a\":{\"b\":1,\"c\":3},\"d\":[1,2],\"f\":{\"g\":1}}");
+    auto merge = merge_diff(d, e);
+    CHECK(merge->to_json() == "{\"e\":null,\"a\":{\"c\":3},\"d\":[1,2],\"f\":{\"g\":1}}");
+    apply_merge_patch(d, *merge);
+    CHECK(json_equal(d, e));
+
+    Json_object_descriptor typed;
+    Json_int_descriptor ji(1);
+    typed.add_member("x", ji, true);
+    Json_object_descriptor other;
+    Json_int_descriptor jj(2);
+    other.add_member("x", jj, true);
+    apply_patch(typed, *diff(typed, other));
+    CHECK(typed.to_json() == "{\"x\":2}");
+
+    Json_variant_descriptor root;
+    root.from_json("10");
+    Json_variant_descriptor replace_root;
+    replace_root.from_json("[{\"op\":\"replace\",\"path\":\"\",\"value\":\"x\"}]");
+    apply_patch(root, replace_root);
+    CHECK(root.to_json() == "\"x\"");
+    Json_variant_descriptor merge_root;
+    merge_root.from_json("{\"a\":1}");
+    apply_merge_patch(root, merge_root);
+    CHECK(root.to_json() == "{\"a\":1}");
+    Json_int_descriptor typed_root(10);
+    CHECK_THROWS(apply_patch(typed_root, replace_root));
+
+    Json_object_descriptor optional;
+    Json_int_descriptor one(1);
+    optional.add_member("x", one, true);
+    Json_variant_descriptor add_y;
+    add_y.from_json("[{\"op\":\"add\",\"path\":\"/y\",\"value\":2}]");
+    apply_patch(optional, add_y);
+    CHECK(optional.to_json() == "{\"x\":1,\"y\":2}");
+    CHECK(!optional.members_mandatory[1]);
+    optional.from_json("{\"x\":3}");
+    CHECK(optional.to_json() == "{\"x\":3,\"y\":2}");
+}
+
+TEST_CASE("json_query"){
+    Json_list_descriptor jl;
+    for (int i = 0; i < 20000; i++) {
+        Json_object_descriptor jo;
+        jo.set("id", i);
+        jo.set("group", string(i % 3 ? "odd" : "even"));
+        Json_object_descriptor position;
+        position.set("x", (float) (i % 10) / 2);
+        jo.set("position", position);
+        jl.value.values.push_back(jo.new_item());
+    }
+    Json_int_descriptor limit(100);
+    auto indices = where_indices(jl, "id", get_query_operator("<"), limit);
+    CHECK(indices.size() == 100);
+    CHECK(indices[99] == 99);
+    auto filtered = where(jl, "position.x", get_query_operator(">="), Json_float_descriptor(4.5));
+    CHECK(static_cast<Json_list_descriptor &>(*filtered).value.values.size() == 2000);
+    CHECK(where_indices(jl, "group", get_query_operator("=="), Json_string_descriptor("even")).size() == 6667);
+    CHECK(where_indices(jl, "missing", get_query_operator("=="), Json_null_descriptor()).size() == 20000);
+    CHECK(where_indices(jl, "group", get_query_operator(">"), limit).empty());
+    CHECK_THROWS(get_query_operator("=~"));
+
+    auto ids = column(jl, "id");
+    CHECK(static_cast<Json_list_descriptor &>(*ids).value.values[12345]->to_json() == "12345");
+    auto selected = select_members(jl, {"id", "missing"});
+    CHECK(static_cast<Json_list_descriptor &>(*selected).value.values[7]->to_json() == "{\"id\":7,\"missing\":null}");
+
+    auto a = aggregate(jl, "id");
+    CHECK(a.count == 20000);
+    CHECK(a.integer);
+    CHECK(a.integer_sum == 199990000);
+    CHECK(a.sum == 199990000.0);
+    CHECK(a.min == 0);
+    CHECK(a.max == 19999);
+    auto x = aggregate(jl, "position.x");
+    CHECK(!x.integer);
+    CHECK(x.max == 4.5);
+    CHECK_THROWS(aggregate(jl, "group"));
+    CHECK(aggregate(jl, "missing").count == 0);
+
+    auto groups = group_by_indices(jl, "group");
+    CHECK(groups.size() == 2);
+    CHECK(groups[0].key->to_json() == "\"even\"");
+    CHECK(groups[0].indices.size() == 6667);
+    CHECK(groups[1].indices[0] == 1);
+    auto grouped = group_by(jl, "position.x");
+    CHECK(static_cast<Json_list_descriptor &>(*grouped).value.values.size() == 10);
+    CHECK(static_cast<Json_object_descriptor &>(*static_cast<Json_list_descriptor &>(*grouped).value.values[1]).get("key").to_json() == "0.5");
+
+    Json_variant_descriptor mixed;
+    mixed.from_json("[{\"k\":\"1\"},{\"k\":1},{\"k\":1.0},{\"k\":\"null\"},{\"k\":null},{},{\"k\":true}]");
+    auto mixed_groups = group_by_indices(static_cast<Json_list_descriptor &>(json_resolve(mixed)), "k");
+    CHECK(mixed_groups.size() == 5);
+    CHECK((mixed_groups[1].indices == vector<size_t>{1, 2}));
+    CHECK(mixed_groups[3].key->get_type() == Json_descriptor::Json_descriptor_type::Null);
+    CHECK((mixed_groups[3].indices == vector<size_t>{4, 5}));
+}
+
+// unique per process, so concurrent test runs do not share the segment
+static int process_id() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+TEST_CASE("Json_shared_document"){
+    string json = "{\"name\":\"shared\",\"count\":3,\"ratio\":0.5,\"ok\":true,\"none\":null,\"items\":[1,\"two\",[],{}],\"nested\":{\"b\":1,\"a\":2}}";
+    Json_variant_descriptor source;
+    source.from_json(json);
+
+    auto buffer = Json_shared_document::serialize(source);
+    Json_shared_document view(buffer.data(), buffer.size());
+    auto root = view.root();
+    CHECK(root.to_json() == json);
+    CHECK(root.size() == 7);
+    CHECK(root["name"].get_string() == "shared");
+    CHECK(root["count"].get_int() == 3);
+    CHECK(root["count"].get_float() == 3);
+    CHECK(root["ratio"].get_float() == 0.5);
+    CHECK(root["ok"].get_bool());
+    CHECK(root["none"].is_null());
+    CHECK(root["items"][1].get_string() == "two");
+    CHECK(root["items"][2].size() == 0);
+    CHECK(root["nested"].key(0) == "b");
+    CHECK(root["nested"]["a"].get_int() == 2);
+    CHECK(root.contains("items"));
+    CHECK(!root.contains("missing"));
+    CHECK_THROWS(root["missing"]);
+    CHECK_THROWS(root["items"][4]);
+    CHECK_THROWS(root["name"].get_int());
+    CHECK(root.to_descriptor()->to_json() == json);
+
+    Static_point_descriptor point(Static_point{5, 6});
+    auto point_buffer = Json_shared_document::serialize(point);
+    CHECK(Json_shared_document(point_buffer.data(), point_buffer.size()).root()["y"].get_int() == 6);
+
+    string corrupted = buffer;
+    corrupted[0] = 'X';
+    CHECK_THROWS(Json_shared_document(corrupted.data(), corrupted.size()));
+    CHECK_THROWS(Json_shared_document(buffer.data(), buffer.size() - 1));
+
+    string name = "json_cpp2_test_" + to_string(process_id());
+    {
+        auto created = Json_shared_document::create(name, source);
+        CHECK_THROWS(Json_shared_document::create(name, source));
+        auto attached = Json_shared_document::attach(name);
+        CHECK(attached.size() == buffer.size());
+        CHECK(attached.root()["items"][3].to_json() == "{}");
+        // the same physical pages, mapped twice
+        CHECK(attached.data() != created.data());
+        CHECK(memcmp(attached.data(), created.data(), created.size()) == 0);
+    }
+    Json_shared_document::unlink(name);
+    CHECK_THROWS(Json_shared_document::attach(name));
+
+    Json_shared_document::create_file("shared_test.json_shared", source);
+    auto file = Json_shared_document::attach_file("shared_test.json_shared");
+    CHECK(file.root().to_json() == json);
+    remove("shared_test.json_shared");
+}
+
 //TEST_CASE("Json_value_bool"){
 //    Python_value v(json_cpp::Python_type::Bool);
 //    CHECK(v.get_python_type() == "bool");
@@ -0,0 +1,313 @@
+#include "../include/json_query.h"
+#include "../include/json_patch.h"
+#include "json_number.h"
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+namespace json_cpp {
+
+    namespace {
+
+        using Json_descriptor_type = Json_descriptor::Json_descriptor_type;
+
+        // below this many items per thread, spawning threads costs more than it saves
+        const size_t min_chunk_size = 4096;
+
+        size_t chunk_count(size_t size) {
+            size_t threads = max(1u, thread::hardware_concurrency());
+            return max<size_t>(1, min(threads, size / min_chunk_size));
+        }
+
+        // runs task(chunk, begin, end) over contiguous chunks of [0, size), one thread per chunk
+        template <class T>
+        void parallel_chunks(size_t size, size_t chunks, T task) {
+            vector<exception_ptr> errors(chunks);
+            auto run = [&](size_t c) {
+                try {
+                    task(c, size * c / chunks, size * (c + 1) / chunks);
+                } catch (...) {
+                    errors[c] = current_exception();
+                }
+            };
+            vector<thread> workers;
+            for (size_t c = 1; c < chunks; c++) workers.emplace_back(run, c);
+            run(0);
+            for (auto &worker: workers) worker.join();
+            for (auto &error: errors) {
+                if (error) rethrow_exception(error);
+            }
+        }
+
+        vector<string> split_path(const string &path) {
+            vector<string> tokens;
+            if (path.empty()) return tokens;
+            size_t start = 0;
+            while (true) {
+                auto end = path.find('.', start);
+                tokens.push_back(path.substr(start, end - start));
+                if (end == string::npos) break;
+                start = end + 1;
+            }
+            return tokens;
+        }
+
+        const Json_descriptor *find_path(const Json_descriptor &item, const vector<string> &path) {
+            auto node = &json_resolve(item);
+            for (auto &token: path) {
+                const Json_descriptor *next = nullptr;
+                if (auto o = dynamic_cast<const Json_object_descriptor *>(node)) {
+                    for (size_t i = 0; i < o->members_name.size(); i++) {
+                        if (o->members_name[i] == token) {
+                            next = o->members_descriptor.values[i].get();
+                            break;
+                        }
+                    }
+                } else if (auto l = dynamic_cast<const Json_list_descriptor *>(node)) {
+                    if (!token.empty() && token.find_first_not_of("0123456789") == string::npos) {
+                        auto index = stoul(token);
+                        if (index < l->value.values.size()) next = l->value.values[index].get();
+                    }
+                }
+                if (!next) return nullptr;
+                node = &json_resolve(*next);
+            }
+            return node;
+        }
+
+        using json_number::is_number;
+        using json_number::number_value;
+
+        // only numbers, strings and bools are ordered
+        bool order(const Json_descriptor &a, const Json_descriptor &b, int &result) {
+            auto a_type = a.get_type();
+            auto b_type = b.get_type();
+            if (is_number(a_type) && is_number(b_type)) {
+                auto x = number_value(a), y = number_value(b);
+                result = x < y ? -1 : (x > y ? 1 : 0);
+                return true;
+            }
+            if (a_type != b_type) return false;
+            if (a_type == Json_descriptor_type::String) {
+                result = dynamic_cast<const Json_string_descriptor &>(a).value.compare(dynamic_cast<const Json_string_descriptor &>(b).value);
+                return true;
+            }
+            if (a_type == Json_descriptor_type::Bool) {
+                result = (int) dynamic_cast<const Json_bool_descriptor &>(a).value - (int) dynamic_cast<const Json_bool_descriptor &>(b).value;
+                return true;
+            }
+            return false;
+        }
+
+        bool matches(const Json_descriptor *value, Json_query_operator op, const Json_descriptor &operand) {
+            static const Json_null_descriptor null_value;
+            if (!value) value = &null_value;
+            if (op == Json_query_operator::Equal) return json_equal(*value, operand);
+            if (op == Json_query_operator::Not_equal) return !json_equal(*value, operand);
+            int result;
+            if (!order(*value, operand, result)) return false;
+            switch (op) {
+                case Json_query_operator::Less:
+                    return result < 0;
+                case Json_query_operator::Less_equal:
+                    return result <= 0;
+                case Json_query_operator::Greater:
+                    return result > 0;
+                case Json_query_operator::Greater_equal:
+                    return result >= 0;
+                default:
+                    return false;
+            }
+        }
+
+        // the type tag keeps "1" apart from 1 and "null" apart from null. numbers are keyed by their value
+        // as a double, exact for the int range, so equal ints and floats fall in the same group
+        string group_key(const Json_descriptor *value) {
+            auto type = value ? value->get_type() : Json_descriptor_type::Null;
+            string key(1, (char) type);
+            if (is_number(type)) {
+                double number = number_value(*value);
+                if (number == 0) number = 0; // -0.0
+                key[0] = (char) Json_descriptor_type::Float;
+                key.append(reinterpret_cast<const char *>(&number), sizeof number);
+            } else if (type == Json_descriptor_type::String) {
+                key += dynamic_cast<const Json_string_descriptor &>(*value).value;
+            } else if (type != Json_descriptor_type::Null) {
+                key += value->to_json();
+            }
+            return key;
+        }
+
+        Json_descriptor_ptr copy_or_null(const Json_descriptor *value) {
+            if (value) return value->new_item();
+            return make_unique<Json_null_descriptor>();
+        }
+
+        Json_descriptor_ptr gather(const Json_list_descriptor &list, const vector<size_t> &indices) {
+            auto &items = list.value.values;
+            vector<Json_descriptor_ptr> values(indices.size());
+            parallel_chunks(indices.size(), chunk_count(indices.size()), [&](size_t, size_t begin, size_t end) {
+                for (size_t k = begin; k < end; k++) values[k] = items[indices[k]]->new_item();
+            });
+            auto result = make_unique<Json_list_descriptor>();
+            result->value.values = std::move(values);
+            return result;
+        }
+    }
+
+    Json_query_operator get_query_operator(const std::string &op) {
+        if (op == "==") return Json_query_operator::Equal;
+        if (op == "!=") return Json_query_operator::Not_equal;
+        if (op == "<") return Json_query_operator::Less;
+        if (op == "<=") return Json_query_operator::Less_equal;
+        if (op == ">") return Json_query_operator::Greater;
+        if (op == ">=") return Json_query_operator::Greater_equal;
+        throw invalid_argument("unknown operator " + op);
+    }
+
+    std::vector<size_t> where_indices(const Json_list_descriptor &list, const std::string &path, Json_query_operator op, const Json_descriptor &value) {
+        auto &items = list.value.values;
+        auto tokens = split_path(path);
+        auto &operand = json_resolve(value);
+        auto chunks = chunk_count(items.size());
+        vector<vector<size_t>> partial(chunks);
+        parallel_chunks(items.size(), chunks, [&](size_t c, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (matches(find_path(*items[i], tokens), op, operand)) partial[c].push_back(i);
+            }
+        });
+        vector<size_t> indices;
+        for (auto &p: partial) indices.insert(indices.end(), p.begin(), p.end());
+        return indices;
+    }
+
+    Json_descriptor_ptr where(const Json_list_descriptor &list, const std::string &path, Json_query_operator op, const Json_descriptor &value) {
+        return gather(list, where_indices(list, path, op, value));
+    }
+
+    Json_descriptor_ptr select_members(const Json_list_descriptor &list, const std::vector<std::string> &members) {
+        auto &items = list.value.values;
+        vector<vector<string>> paths;
+        for (auto &member: members) paths.push_back({member});
+        vector<Json_descriptor_ptr> values(items.size());
+        parallel_chunks(items.size(), chunk_count(items.size()), [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (!dynamic_cast<const Json_object_descriptor *>(&json_resolve(*items[i])))
+                    throw logic_error("select can only be used with lists of objects");
+                auto o = make_unique<Json_object_descriptor>();
+                for (size_t m = 0; m < members.size(); m++) {
+                    o->members_name.push_back(members[m]);
+                    o->members_descriptor.values.push_back(copy_or_null(find_path(*items[i], paths[m])));
+                    o->members_mandatory.push_back(false);
+                }
+                values[i] = std::move(o);
+            }
+        });
+        auto result = make_unique<Json_list_descriptor>();
+        result->value.values = std::move(values);
+        return result;
+    }
+
+    Json_descriptor_ptr column(const Json_list_descriptor &list, const std::string &path) {
+        auto &items = list.value.values;
+        auto tokens = split_path(path);
+        vector<Json_descriptor_ptr> values(items.size());
+        parallel_chunks(items.size(), chunk_count(items.size()), [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) values[i] = copy_or_null(find_path(*items[i], tokens));
+        });
+        auto result = make_unique<Json_list_descriptor>();
+        result->value.values = std::move(values);
+        return result;
+    }
+
+    Json_query_aggregate aggregate(const Json_list_descriptor &list, const std::string &path) {
+        auto &items = list.value.values;
+        auto tokens = split_path(path);
+        auto chunks = chunk_count(items.size());
+        vector<Json_query_aggregate> partial(chunks);
+        parallel_chunks(items.size(), chunks, [&](size_t c, size_t begin, size_t end) {
+            auto &a = partial[c];
+            for (size_t i = begin; i < end; i++) {
+                auto value = find_path(*items[i], tokens);
+                if (!value || value->get_type() == Json_descriptor_type::Null) continue;
+                if (!is_number(value->get_type())) throw logic_error("aggregates can only be computed on numeric values");
+                auto v = number_value(*value);
+                a.min = a.count ? min(a.min, v) : v;
+                a.max = a.count ? max(a.max, v) : v;
+                a.sum += v;
+                if (value->get_type() == Json_descriptor_type::Int) a.integer_sum += dynamic_cast<const Json_int_descriptor &>(*value).value;
+                else a.integer = false;
+                a.count++;
+            }
+        });
+        Json_query_aggregate result;
+        for (auto &a: partial) {
+            if (!a.count) continue;
+            result.min = result.count ? min(result.min, a.min) : a.min;
+            result.max = result.count ? max(result.max, a.max) : a.max;
+            result.sum += a.sum;
+            result.integer_sum += a.integer_sum;
+            result.integer = result.integer && a.integer;
+            result.count += a.count;
+        }
+        return result;
+    }
+
+    std::vector<Json_query_group> group_by_indices(const Json_list_descriptor &list, const std::string &path) {
+        struct Groups {
+            unordered_map<string, size_t> index;
+            vector<string> keys;
+            vector<Json_query_group> groups;
+        };
+        auto &items = list.value.values;
+        auto tokens = split_path(path);
+        auto chunks = chunk_count(items.size());
+        vector<Groups> partial(chunks);
+        parallel_chunks(items.size(), chunks, [&](size_t c, size_t begin, size_t end) {
+            auto &p = partial[c];
+            for (size_t i = begin; i < end; i++) {
+                auto value = find_path(*items[i], tokens);
+                auto key = group_key(value);
+                auto g = p.index.find(key);
+                if (g == p.index.end()) {
+                    p.index.emplace(key, p.groups.size());
+                    p.keys.push_back(std::move(key));
+                    p.groups.push_back({copy_or_null(value), {i}});
+                } else {
+                    p.groups[g->second].indices.push_back(i);
+                }
+            }
+        });
+        vector<Json_query_group> groups;
+        unordered_map<string, size_t> index;
+        for (auto &p: partial) {
+            for (size_t g = 0; g < p.groups.size(); g++) {
+                auto found = index.find(p.keys[g]);
+                if (found == index.end()) {
+                    index.emplace(std::move(p.keys[g]), groups.size());
+                    groups.push_back(std::move(p.groups[g]));
+                } else {
+                    auto &indices = groups[found->second].indices;
+                    indices.insert(indices.end(), p.groups[g].indices.begin(), p.groups[g].indices.end());
+                }
+            }
+        }
+        return groups;
+    }
+
+    Json_descriptor_ptr group_by(const Json_list_descriptor &list, const std::string &path) {
+        auto result = make_unique<Json_list_descriptor>();
+        for (auto &group: group_by_indices(list, path)) {
+            auto o = make_unique<Json_object_descriptor>();
+            o->members_name = {"key", "items"};
+            o->members_descriptor.values.push_back(std::move(group.key));
+            o->members_descriptor.values.push_back(gather(list, group.indices));
+            o->members_mandatory = {false, false};
+            result->value.values.push_back(std::move(o));
+        }
+        return result;
+    }
+}
@@ -0,0 +1,676 @@
+#include "../include/json_shared.h"
+#include "json_cpp/json_util.h"
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace json_cpp {
+
+    namespace {
+
+        using Json_descriptor_type = Json_descriptor::Json_descriptor_type;
+
+        const char shared_magic[8] = {'J', 'S', 'O', 'N', 'C', 'P', 'P', 'S'};
+        const uint32_t shared_version = 1;
+
+        struct Shared_header {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t size;
+            uint64_t root;
+        };
+
+        // value holds bools, ints, the bits of floats, the length of strings and the size of lists and objects
+        struct Shared_node {
+            uint32_t type;
+            uint32_t reserved;
+            uint64_t value;
+        };
+
+        const uint64_t node_size = sizeof(Shared_node);
+
+        [[noreturn]] void corrupted() {
+            throw logic_error("format error: corrupted json shared document");
+        }
+
+        // lays out the nodes depth first. without a base it only computes the size,
+        // so the same code sizes the document and then writes it.
+        struct Shared_writer {
+            char *base{nullptr};
+            uint64_t position{sizeof(Shared_header)};
+
+            uint64_t reserve(uint64_t bytes) {
+                auto at = position;
+                position += (bytes + 7) & ~(uint64_t) 7;
+                return at;
+            }
+
+            void put(uint64_t at, const void *source, size_t size) {
+                if (base) memcpy(base + at, source, size);
+            }
+
+            void put(uint64_t at, uint64_t value) {
+                put(at, &value, sizeof value);
+            }
+
+            uint64_t node(Json_descriptor_type type, uint64_t value) {
+                auto at = reserve(node_size);
+                Shared_node n{(uint32_t) type, 0, value};
+                put(at, &n, sizeof n);
+                return at;
+            }
+
+            // the terminating zero comes from the zero filled memory
+            uint64_t write_string(const std::string &value) {
+                auto at = node(Json_descriptor_type::String, value.size());
+                put(reserve(value.size() + 1), value.data(), value.size());
+                return at;
+            }
+
+            uint64_t write(const Json_descriptor &descriptor) {
+                auto &d = json_resolve(descriptor);
+                switch (d.get_type()) {
+                    case Json_descriptor_type::Bool:
+                        return node(Json_descriptor_type::Bool, dynamic_cast<const Json_bool_descriptor &>(d).value);
+                    case Json_descriptor_type::Int:
+                        return node(Json_descriptor_type::Int, (uint64_t) (int64_t) dynamic_cast<const Json_int_descriptor &>(d).value);
+                    case Json_descriptor_type::Float: {
+                        double value = dynamic_cast<const Json_float_descriptor &>(d).value;
+                        uint64_t bits;
+                        memcpy(&bits, &value, sizeof bits);
+                        return node(Json_descriptor_type::Float, bits);
+                    }
+                    case Json_descriptor_type::String:
+                        return write_string(dynamic_cast<const Json_string_descriptor &>(d).value);
+                    case Json_descriptor_type::List:
+                        if (auto l = dynamic_cast<const Json_list_descriptor *>(&d)) return write_list(*l);
+                        return reparsed(d);
+                    case Json_descriptor_type::Object:
+                        if (auto o = dynamic_cast<const Json_object_descriptor *>(&d)) return write_object(*o);
+                        return reparsed(d);
+                    default:
+                        return node(Json_descriptor_type::Null, 0);
+                }
+            }
+
+            uint64_t write_list(const Json_list_descriptor &l) {
+                auto &items = l.value.values;
+                auto at = node(Json_descriptor_type::List, items.size());
+                auto table = reserve(items.size() * 8);
+                for (size_t i = 0; i < items.size(); i++) put(table + i * 8, write(*items[i]));
+                return at;
+            }
+
+            uint64_t write_object(const Json_object_descriptor &o) {
+                auto &names = o.members_name;
+                auto count = names.size();
+                auto at = node(Json_descriptor_type::Object, count);
+                auto entries = reserve(count * 16);
+                auto sorted = reserve(count * 8);
+                for (size_t m = 0; m < count; m++) {
+                    put(entries + m * 16, write_string(names[m]));
+                    put(entries + m * 16 + 8, write(*o.members_descriptor.values[m]));
+                }
+                if (base) {
+                    vector<uint64_t> order(count);
+                    iota(order.begin(), order.end(), 0);
+                    sort(order.begin(), order.end(), [&names](uint64_t a, uint64_t b) { return names[a] < names[b]; });
+                    for (size_t m = 0; m < count; m++) put(sorted + m * 8, order[m]);
+                }
+                return at;
+            }
+
+            // objects and lists that are not dynamic descriptors (Json_static_object) are laid out from their json
+            uint64_t reparsed(const Json_descriptor &d) {
+                Json_variant_descriptor variant;
+                variant.from_json(d.to_json());
+                return write(variant);
+            }
+        };
+
+        uint64_t shared_size(const Json_descriptor &descriptor) {
+            Shared_writer writer;
+            writer.write(descriptor);
+            return writer.position;
+        }
+
+        // the magic goes last so a reader attaching while the document is written does not accept it
+        void shared_write(const Json_descriptor &descriptor, char *base, uint64_t size) {
+            Shared_writer writer;
+            writer.base = base;
+            Shared_header header{};
+            header.version = shared_version;
+            header.size = size;
+            header.root = writer.write(descriptor);
+            memcpy(base, &header, sizeof header);
+            atomic_thread_fence(memory_order_release);
+            memcpy(base, shared_magic, sizeof shared_magic);
+        }
+
+        // returns the size of the document
+        size_t shared_check(const char *data, size_t size) {
+            Shared_header header;
+            if (size < sizeof header) corrupted();
+            memcpy(&header, data, sizeof header);
+            atomic_thread_fence(memory_order_acquire);
+            if (memcmp(header.magic, shared_magic, sizeof shared_magic)) throw logic_error("format error: not a json shared document");
+            if (header.version != shared_version) throw logic_error("format error: unsupported json shared document version");
+            if (header.size > size || header.root < sizeof header || header.root > header.size - node_size) corrupted();
+            return header.size;
+        }
+
+        uint64_t shared_root(const char *data) {
+            Shared_header header;
+            memcpy(&header, data, sizeof header);
+            return header.root;
+        }
+
+        // mappings are created writable, sized for the document, and made read-only once it is written.
+        // existing documents are mapped read-only.
+#ifdef _WIN32
+        string error_message(const string &message) {
+            return message + ": system error " + to_string(GetLastError());
+        }
+
+        [[noreturn]] void system_error(const string &message) {
+            throw runtime_error(error_message(message));
+        }
+
+        char *map_view(HANDLE mapping, DWORD access, const string &target) {
+            auto view = MapViewOfFile(mapping, access, 0, 0, 0);
+            auto message = view ? string() : error_message("unable to map " + target);
+            CloseHandle(mapping);
+            if (!view) throw runtime_error(message);
+            return (char *) view;
+        }
+
+        // named mappings exist while a process has a view of them, there is nothing to remove
+        char *create_shared_memory(const string &name, uint64_t size) {
+            auto mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD) (size >> 32), (DWORD) size, name.c_str());
+            if (!mapping) system_error("unable to create shared memory " + name);
+            if (GetLastError() == ERROR_ALREADY_EXISTS) {
+                CloseHandle(mapping);
+                throw runtime_error("unable to create shared memory " + name + ": already exists");
+            }
+            return map_view(mapping, FILE_MAP_WRITE, "shared memory " + name);
+        }
+
+        char *open_shared_memory(const string &name, uint64_t &size) {
+            auto mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+            if (!mapping) system_error("unable to open shared memory " + name);
+            auto view = map_view(mapping, FILE_MAP_READ, "shared memory " + name);
+            MEMORY_BASIC_INFORMATION info{};
+            VirtualQuery(view, &info, sizeof info);
+            size = (uint64_t) info.RegionSize;
+            return view;
+        }
+
+        void remove_shared_memory(const string &) {
+        }
+
+        char *create_mapped_file(const string &file_path, uint64_t size) {
+            auto file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) system_error("unable to open file " + file_path);
+            auto mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD) (size >> 32), (DWORD) size, nullptr);
+            auto message = mapping ? string() : error_message("unable to allocate file " + file_path);
+            CloseHandle(file);
+            if (!mapping) throw runtime_error(message);
+            return map_view(mapping, FILE_MAP_WRITE, "file " + file_path);
+        }
+
+        char *open_mapped_file(const string &file_path, uint64_t &size) {
+            auto file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) system_error("unable to open file " + file_path);
+            LARGE_INTEGER file_size{};
+            GetFileSizeEx(file, &file_size);
+            size = (uint64_t) file_size.QuadPart;
+            if (size < sizeof(Shared_header)) {
+                CloseHandle(file);
+                throw logic_error("format error: not a json shared document");
+            }
+            auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            auto message = mapping ? string() : error_message("unable to map file " + file_path);
+            CloseHandle(file);
+            if (!mapping) throw runtime_error(message);
+            return map_view(mapping, FILE_MAP_READ, "file " + file_path);
+        }
+
+        void replace_file(const string &source, const string &destination) {
+            if (MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING)) return;
+            auto message = error_message("unable to write file " + destination);
+            remove(source.c_str());
+            throw runtime_error(message);
+        }
+
+        void protect(char *memory, uint64_t size) {
+            DWORD previous;
+            VirtualProtect(memory, size, PAGE_READONLY, &previous);
+        }
+
+        void unmap(const char *memory, uint64_t) {
+            UnmapViewOfFile(memory);
+        }
+
+        unsigned long process_id() {
+            return GetCurrentProcessId();
+        }
+#else
+        string error_message(const string &message) {
+            return message + ": " + strerror(errno);
+        }
+
+        [[noreturn]] void system_error(const string &message) {
+            throw runtime_error(error_message(message));
+        }
+
+        string shared_memory_name(const string &name) {
+            if (!name.empty() && name[0] == '/') return name;
+            return "/" + name;
+        }
+
+        char *map_new(int fd, uint64_t size, const string &target) {
+            if (ftruncate(fd, (off_t) size)) {
+                auto message = error_message("unable to allocate " + target);
+                close(fd);
+                throw runtime_error(message);
+            }
+            auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (memory == MAP_FAILED) system_error("unable to map " + target);
+            return (char *) memory;
+        }
+
+        char *map_existing(int fd, uint64_t &size, const string &target) {
+            struct stat status{};
+            if (fstat(fd, &status)) {
+                auto message = error_message("unable to read " + target);
+                close(fd);
+                throw runtime_error(message);
+            }
+            size = (uint64_t) status.st_size;
+            if (size < sizeof(Shared_header)) {
+                close(fd);
+                throw logic_error("format error: not a json shared document");
+            }
+            auto memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (memory == MAP_FAILED) system_error("unable to map " + target);
+            return (char *) memory;
+        }
+
+        char *create_shared_memory(const string &name, uint64_t size) {
+            int fd = shm_open(shared_memory_name(name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0) system_error("unable to create shared memory " + name);
+            return map_new(fd, size, "shared memory " + name);
+        }
+
+        char *open_shared_memory(const string &name, uint64_t &size) {
+            int fd = shm_open(shared_memory_name(name).c_str(), O_RDONLY, 0);
+            if (fd < 0) system_error("unable to open shared memory " + name);
+            return map_existing(fd, size, "shared memory " + name);
+        }
+
+        void remove_shared_memory(const string &name) {
+            if (shm_unlink(shared_memory_name(name).c_str())) system_error("unable to remove shared memory " + name);
+        }
+
+        char *create_mapped_file(const string &file_path, uint64_t size) {
+            int fd = open(file_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+            if (fd < 0) system_error("unable to open file " + file_path);
+            return map_new(fd, size, "file " + file_path);
+        }
+
+        char *open_mapped_file(const string &file_path, uint64_t &size) {
+            int fd = open(file_path.c_str(), O_RDONLY);
+            if (fd < 0) system_error("unable to open file " + file_path);
+            return map_existing(fd, size, "file " + file_path);
+        }
+
+        void replace_file(const string &source, const string &destination) {
+            if (!rename(source.c_str(), destination.c_str())) return;
+            auto message = error_message("unable to write file " + destination);
+            remove(source.c_str());
+            throw runtime_error(message);
+        }
+
+        void protect(char *memory, uint64_t size) {
+            mprotect(memory, size, PROT_READ);
+        }
+
+        void unmap(const char *memory, uint64_t size) {
+            munmap((void *) memory, size);
+        }
+
+        unsigned long process_id() {
+            return (unsigned long) getpid();
+        }
+#endif
+
+        void publish(char *memory, uint64_t size, const Json_descriptor &descriptor) {
+            try {
+                shared_write(descriptor, memory, size);
+            } catch (...) {
+                unmap(memory, size);
+                throw;
+            }
+            protect(memory, size);
+        }
+    }
+
+    Json_shared_value::Json_shared_value(const char *data, size_t size, uint64_t offset) :
+            data(data),
+            data_size(size),
+            offset(offset) {
+        if (offset % 8 || offset > size || size - offset < node_size) corrupted();
+    }
+
+    uint64_t Json_shared_value::read(uint64_t at) const {
+        if (at > data_size || data_size - at < 8) corrupted();
+        uint64_t value;
+        memcpy(&value, data + at, sizeof value);
+        return value;
+    }
+
+    uint64_t Json_shared_value::expect(Json_descriptor_type type) const {
+        if (get_type() != type) {
+            if (type == Json_descriptor_type::Object) throw logic_error("value is not an object");
+            if (type == Json_descriptor_type::List) throw logic_error("value is not a list");
+            throw logic_error("value is of the wrong type");
+        }
+        return read(offset + 8);
+    }
+
+    Json_descriptor::Json_descriptor_type Json_shared_value::get_type() const {
+        uint32_t type;
+        memcpy(&type, data + offset, sizeof type);
+        if (type > (uint32_t) Json_descriptor_type::List) corrupted();
+        return (Json_descriptor_type) type;
+    }
+
+    bool Json_shared_value::is_null() const {
+        return get_type() == Json_descriptor_type::Null;
+    }
+
+    bool Json_shared_value::get_bool() const {
+        return expect(Json_descriptor_type::Bool) != 0;
+    }
+
+    int64_t Json_shared_value::get_int() const {
+        return (int64_t) expect(Json_descriptor_type::Int);
+    }
+
+    double Json_shared_value::get_float() const {
+        if (get_type() == Json_descriptor_type::Int) return (double) get_int();
+        auto bits = expect(Json_descriptor_type::Float);
+        double value;
+        memcpy(&value, &bits, sizeof value);
+        return value;
+    }
+
+    std::string_view Json_shared_value::get_string() const {
+        auto length = expect(Json_descriptor_type::String);
+        auto start = offset + node_size;
+        if (start > data_size || data_size - start < length) corrupted();
+        return {data + start, length};
+    }
+
+    size_t Json_shared_value::size() const {
+        auto type = get_type();
+        if (type != Json_descriptor_type::List && type != Json_descriptor_type::Object) throw logic_error("value is not a list or an object");
+        return read(offset + 8);
+    }
+
+    Json_shared_value Json_shared_value::operator[](size_t index) const {
+        if (index >= expect(Json_descriptor_type::List)) throw out_of_range("list index out of range");
+        return {data, data_size, read(offset + node_size + index * 8)};
+    }
+
+    std::string_view Json_shared_value::key(size_t index) const {
+        if (index >= expect(Json_descriptor_type::Object)) throw out_of_range("member index out of range");
+        return Json_shared_value(data, data_size, read(offset + node_size + index * 16)).get_string();
+    }
+
+    Json_shared_value Json_shared_value::value(size_t index) const {
+        if (index >= expect(Json_descriptor_type::Object)) throw out_of_range("member index out of range");
+        return {data, data_size, read(offset + node_size + index * 16 + 8)};
+    }
+
+    bool Json_shared_value::find(std::string_view name, Json_shared_value &member) const {
+        auto count = expect(Json_descriptor_type::Object);
+        auto sorted = offset + node_size + count * 16;
+        uint64_t low = 0, high = count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            auto index = read(sorted + middle * 8);
+            if (index >= count) corrupted();
+            auto comparison = key(index).compare(name);
+            if (comparison == 0) {
+                member = value(index);
+                return true;
+            }
+            if (comparison < 0) low = middle + 1;
+            else high = middle;
+        }
+        return false;
+    }
+
+    bool Json_shared_value::contains(std::string_view name) const {
+        auto member = *this;
+        return find(name, member);
+    }
+
+    Json_shared_value Json_shared_value::operator[](std::string_view name) const {
+        auto member = *this;
+        if (!find(name, member)) throw logic_error("member " + std::string(name) + " is not defined.");
+        return member;
+    }
+
+    void Json_shared_value::json_write(std::ostream &o) const {
+        switch (get_type()) {
+            case Json_descriptor_type::Bool:
+                Json_util::write_value(o, get_bool());
+                break;
+            case Json_descriptor_type::Int:
+                Json_util::write_value(o, (int) get_int());
+                break;
+            case Json_descriptor_type::Float:
+                json_write_number(o, get_float());
+                break;
+            case Json_descriptor_type::String:
+                Json_util::write_value(o, std::string(get_string()));
+                break;
+            case Json_descriptor_type::List: {
+                o << '[';
+                for (size_t i = 0; i < size(); i++) {
+                    if (i) o << ',';
+                    (*this)[i].json_write(o);
+                }
+                o << ']';
+                break;
+            }
+            case Json_descriptor_type::Object: {
+                o << '{';
+                for (size_t m = 0; m < size(); m++) {
+                    if (m) o << ',';
+                    Json_util::write_value(o, std::string(key(m)));
+                    o << ':';
+                    value(m).json_write(o);
+                }
+                o << '}';
+                break;
+            }
+            default:
+                o << "null";
+        }
+    }
+
+    std::string Json_shared_value::to_json() const {
+        stringstream ss;
+        json_write(ss);
+        return ss.str();
+    }
+
+    Json_descriptor_ptr Json_shared_value::to_descriptor() const {
+        switch (get_type()) {
+            case Json_descriptor_type::Bool: {
+                auto d = make_unique<Json_bool_descriptor>();
+                d->value = get_bool();
+                return d;
+            }
+            case Json_descriptor_type::Int: {
+                auto d = make_unique<Json_int_descriptor>();
+                d->value = (int) get_int();
+                return d;
+            }
+            case Json_descriptor_type::Float: {
+                auto d = make_unique<Json_float_descriptor>();
+                d->value = get_float();
+                return d;
+            }
+            case Json_descriptor_type::String: {
+                auto d = make_unique<Json_string_descriptor>();
+                d->value = std::string(get_string());
+                return d;
+            }
+            case Json_descriptor_type::List: {
+                auto d = make_unique<Json_list_descriptor>();
+                for (size_t i = 0; i < size(); i++) d->value.values.push_back((*this)[i].to_descriptor());
+                return d;
+            }
+            case Json_descriptor_type::Object: {
+                auto d = make_unique<Json_object_descriptor>();
+                for (size_t m = 0; m < size(); m++) {
+                    d->members_name.emplace_back(key(m));
+                    d->members_descriptor.values.push_back(value(m).to_descriptor());
+                    d->members_mandatory.push_back(false);
+                }
+                return d;
+            }
+            default:
+                return make_unique<Json_null_descriptor>();
+        }
+    }
+
+    Json_shared_document::Json_shared_document(const char *data, size_t size) :
+            memory(data),
+            memory_size(shared_check(data, size)) {
+    }
+
+    Json_shared_document::Json_shared_document(const char *data, size_t size, size_t mapping_size) :
+            memory(data),
+            mapping_size(mapping_size) {
+        try {
+            memory_size = shared_check(data, size);
+        } catch (...) {
+            unmap(data, mapping_size);
+            throw;
+        }
+    }
+
+    Json_shared_document::Json_shared_document(Json_shared_document &&other) noexcept :
+            memory(other.memory),
+            memory_size(other.memory_size),
+            mapping_size(other.mapping_size) {
+        other.memory = nullptr;
+        other.memory_size = 0;
+        other.mapping_size = 0;
+    }
+
+    Json_shared_document &Json_shared_document::operator = (Json_shared_document &&other) noexcept {
+        if (this != &other) {
+            if (mapping_size) unmap(memory, mapping_size);
+            memory = other.memory;
+            memory_size = other.memory_size;
+            mapping_size = other.mapping_size;
+            other.memory = nullptr;
+            other.memory_size = 0;
+            other.mapping_size = 0;
+        }
+        return *this;
+    }
+
+    Json_shared_document::~Json_shared_document() {
+        if (mapping_size) unmap(memory, mapping_size);
+    }
+
+    Json_shared_value Json_shared_document::root() const {
+        if (!memory) throw logic_error("document is not attached");
+        return {memory, memory_size, shared_root(memory)};
+    }
+
+    const char *Json_shared_document::data() const {
+        return memory;
+    }
+
+    size_t Json_shared_document::size() const {
+        return memory_size;
+    }
+
+    std::string Json_shared_document::serialize(const Json_descriptor &descriptor) {
+        std::string buffer(shared_size(descriptor), '\0');
+        shared_write(descriptor, buffer.data(), buffer.size());
+        return buffer;
+    }
+
+    Json_shared_document Json_shared_document::create(const std::string &name, const Json_descriptor &descriptor) {
+        auto size = shared_size(descriptor);
+        auto memory = create_shared_memory(name, size);
+        try {
+            publish(memory, size, descriptor);
+        } catch (...) {
+            remove_shared_memory(name);
+            throw;
+        }
+        return {memory, size, size};
+    }
+
+    Json_shared_document Json_shared_document::attach(const std::string &name) {
+        uint64_t size;
+        auto memory = open_shared_memory(name, size);
+        return {memory, size, size};
+    }
+
+    void Json_shared_document::unlink(const std::string &name) {
+        remove_shared_memory(name);
+    }
+
+    Json_shared_document Json_shared_document::create_file(const std::string &file_path, const Json_descriptor &descriptor) {
+        auto temporary_path = file_path + ".tmp" + to_string(process_id());
+        auto size = shared_size(descriptor);
+        auto memory = create_mapped_file(temporary_path, size);
+        try {
+            publish(memory, size, descriptor);
+        } catch (...) {
+            remove(temporary_path.c_str());
+            throw;
+        }
+        Json_shared_document document(memory, size, size);
+        replace_file(temporary_path, file_path);
+        return document;
+    }
+
+    Json_shared_document Json_shared_document::attach_file(const std::string &file_path) {
+        uint64_t size;
+        auto memory = open_mapped_file(file_path, size);
+        return {memory, size, size};
+    }
+}
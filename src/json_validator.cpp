@@ -0,0 +1,553 @@
+#include "../include/json_validator.h"
+#include "../include/json_static_descriptor.h"
+#include <cstring>
+#include <cstdint>
+#include <climits>
+
+using namespace std;
+
+namespace json_cpp {
+
+    namespace {
+
+        const unsigned int max_depth = 512;
+
+        bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        bool is_hex_digit(char c) {
+            return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        }
+
+        uint32_t read_hex4(const char *p) {
+            uint32_t v = 0;
+            for (int i = 0; i < 4; i++) {
+                char c = p[i];
+                v = v * 16 + (is_digit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+            }
+            return v;
+        }
+
+        void append_utf8(string &s, uint32_t cp) {
+            if (cp < 0x80) {
+                s += (char) cp;
+            } else if (cp < 0x800) {
+                s += (char) (0xC0 | (cp >> 6));
+                s += (char) (0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                s += (char) (0xE0 | (cp >> 12));
+                s += (char) (0x80 | ((cp >> 6) & 0x3F));
+                s += (char) (0x80 | (cp & 0x3F));
+            } else {
+                s += (char) (0xF0 | (cp >> 18));
+                s += (char) (0x80 | ((cp >> 12) & 0x3F));
+                s += (char) (0x80 | ((cp >> 6) & 0x3F));
+                s += (char) (0x80 | (cp & 0x3F));
+            }
+        }
+
+        // only used for member names containing escape sequences, the common case is compared in place
+        string unescape(const char *p, const char *stop) {
+            string s;
+            while (p < stop) {
+                if (*p != '\\') {
+                    s += *p++;
+                    continue;
+                }
+                p++;
+                char c = *p++;
+                switch (c) {
+                    case 'b': s += '\b'; break;
+                    case 'f': s += '\f'; break;
+                    case 'n': s += '\n'; break;
+                    case 'r': s += '\r'; break;
+                    case 't': s += '\t'; break;
+                    case 'u': {
+                        uint32_t cp = read_hex4(p);
+                        p += 4;
+                        if (cp >= 0xD800 && cp < 0xDC00 && stop - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                            uint32_t low = read_hex4(p + 2);
+                            if (low >= 0xDC00 && low < 0xE000) {
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                                p += 6;
+                            }
+                        }
+                        append_utf8(s, cp);
+                        break;
+                    }
+                    default: s += c;
+                }
+            }
+            return s;
+        }
+
+        // tracks loaded members, only allocates for objects with more than 64 members
+        struct Member_flags {
+            explicit Member_flags(size_t count) {
+                if (count > 64) large.resize(count, false);
+            }
+            bool test(size_t i) const {
+                return large.empty() ? (small >> i) & 1 : large[i];
+            }
+            void set(size_t i) {
+                if (large.empty()) small |= uint64_t(1) << i;
+                else large[i] = true;
+            }
+            uint64_t small{0};
+            vector<bool> large;
+        };
+
+        // reads a slice of the buffer as a stream, for the codecs of static objects
+        struct Slice_buffer : std::streambuf {
+            Slice_buffer(const char *start, const char *stop) {
+                setg(const_cast<char *>(start), const_cast<char *>(start), const_cast<char *>(stop));
+            }
+        };
+
+        struct Json_validator {
+            Json_validator(const char *buffer, size_t size) : begin(buffer), cur(buffer), end(buffer + size) {}
+
+            const char *begin;
+            const char *cur;
+            const char *end;
+            const char *error_at{nullptr};
+            const char *reason{nullptr};
+            string path;
+            string codec_reason;
+            unsigned int depth{0};
+
+            bool fail(const char *r) {
+                return fail(r, cur);
+            }
+
+            bool fail(const char *r, const char *at) {
+                error_at = at;
+                reason = r;
+                return false;
+            }
+
+            // the path is only built while unwinding from an error
+            void prepend(const char *start, const char *stop, bool escaped) {
+                string name = escaped ? unescape(start, stop) : string(start, stop);
+                string segment = "/";
+                for (char c: name) {
+                    if (c == '~') segment += "~0";
+                    else if (c == '/') segment += "~1";
+                    else segment += c;
+                }
+                path = segment + path;
+            }
+
+            void prepend(size_t index) {
+                path = "/" + to_string(index) + path;
+            }
+
+            char skip_blanks() {
+                while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r')) cur++;
+                return cur < end ? *cur : 0;
+            }
+
+            bool nest() {
+                if (++depth > max_depth) return fail("maximum nesting depth exceeded");
+                return true;
+            }
+
+            bool literal(const char *l) {
+                size_t size = strlen(l);
+                if ((size_t) (end - cur) < size || memcmp(cur, l, size) != 0) return fail("format error: invalid literal");
+                cur += size;
+                return true;
+            }
+
+            bool digits() {
+                if (cur >= end || !is_digit(*cur)) return fail("format error: expecting digit");
+                while (cur < end && is_digit(*cur)) cur++;
+                return true;
+            }
+
+            // is_integer is set when the number has neither fraction nor exponent
+            bool number(bool &is_integer) {
+                is_integer = true;
+                if (cur < end && *cur == '-') cur++;
+                if (cur < end && *cur == '0') cur++;
+                else if (!digits()) return false;
+                if (cur < end && *cur == '.') {
+                    is_integer = false;
+                    cur++;
+                    if (!digits()) return false;
+                }
+                if (cur < end && (*cur == 'e' || *cur == 'E')) {
+                    is_integer = false;
+                    cur++;
+                    if (cur < end && (*cur == '+' || *cur == '-')) cur++;
+                    if (!digits()) return false;
+                }
+                return true;
+            }
+
+            bool int_value() {
+                auto start = cur;
+                bool is_integer;
+                if (!number(is_integer)) return false;
+                if (!is_integer) return fail("type error: expecting int", start);
+                auto p = start;
+                bool negative = *p == '-';
+                if (negative) p++;
+                long long v = 0;
+                for (; p < cur; p++) {
+                    v = v * 10 + (*p - '0');
+                    if (v > (long long) INT_MAX + 1) return fail("type error: int out of range", start);
+                }
+                if (!negative && v > INT_MAX) return fail("type error: int out of range", start);
+                return true;
+            }
+
+            // escaped is set when the string contains escape sequences
+            bool string_value(const char *&start, const char *&stop, bool &escaped) {
+                if (cur >= end || *cur != '"') return fail("format error: expecting '\"'");
+                start = ++cur;
+                escaped = false;
+                while (cur < end && *cur != '"') {
+                    if ((unsigned char) *cur < 0x20) return fail("format error: control character in string");
+                    if (*cur == '\\') {
+                        escaped = true;
+                        if (++cur >= end) break;
+                        switch (*cur) {
+                            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                                break;
+                            case 'u':
+                                for (int h = 0; h < 4; h++) {
+                                    if (++cur >= end || !is_hex_digit(*cur)) return fail("format error: invalid unicode escape");
+                                }
+                                break;
+                            default:
+                                return fail("format error: invalid escape sequence");
+                        }
+                    }
+                    cur++;
+                }
+                if (cur >= end) return fail("format error: unterminated string");
+                stop = cur++;
+                return true;
+            }
+
+            bool string_value() {
+                const char *start, *stop;
+                bool escaped;
+                return string_value(start, stop, escaped);
+            }
+
+            bool member_name(const char *&start, const char *&stop, bool &escaped) {
+                if (skip_blanks() != '"') return fail("format error: field name");
+                if (!string_value(start, stop, escaped)) return false;
+                if (skip_blanks() != ':') return fail("format error: expecting ':'");
+                cur++;
+                return true;
+            }
+
+            bool any_value() {
+                char c = skip_blanks();
+                if (cur >= end) return fail("format error: unexpected end of input");
+                switch (c) {
+                    case '{':
+                        return any_object();
+                    case '[':
+                        return any_list();
+                    case '"':
+                        return string_value();
+                    case 't':
+                        return literal("true");
+                    case 'f':
+                        return literal("false");
+                    case 'n':
+                        return literal("null");
+                    default:
+                        if (c == '-' || is_digit(c)) {
+                            bool is_integer;
+                            return number(is_integer);
+                        }
+                        return fail("format error: unexpected character");
+                }
+            }
+
+            bool any_object() {
+                if (!nest()) return false;
+                cur++;
+                if (skip_blanks() != '}') {
+                    while (true) {
+                        const char *start, *stop;
+                        bool escaped;
+                        if (!member_name(start, stop, escaped)) return false;
+                        if (!any_value()) {
+                            prepend(start, stop, escaped);
+                            return false;
+                        }
+                        char c = skip_blanks();
+                        if (c == '}') break;
+                        if (c != ',') return fail("format error: expecting '}'");
+                        cur++;
+                    }
+                }
+                cur++;
+                depth--;
+                return true;
+            }
+
+            bool any_list() {
+                if (!nest()) return false;
+                cur++;
+                if (skip_blanks() != ']') {
+                    for (size_t index = 0;; index++) {
+                        if (!any_value()) {
+                            prepend(index);
+                            return false;
+                        }
+                        char c = skip_blanks();
+                        if (c == ']') break;
+                        if (c != ',') return fail("format error: expecting ']'");
+                        cur++;
+                    }
+                }
+                cur++;
+                depth--;
+                return true;
+            }
+
+            static int find_member(const Json_object_descriptor &o, const char *start, const char *stop, bool escaped) {
+                if (escaped) {
+                    auto name = unescape(start, stop);
+                    for (size_t i = 0; i < o.members_name.size(); i++) {
+                        if (o.members_name[i] == name) return (int) i;
+                    }
+                    return -1;
+                }
+                auto size = (size_t) (stop - start);
+                for (size_t i = 0; i < o.members_name.size(); i++) {
+                    auto &name = o.members_name[i];
+                    if (name.size() == size && memcmp(name.data(), start, size) == 0) return (int) i;
+                }
+                return -1;
+            }
+
+            bool object(const Json_object_descriptor &o) {
+                if (*cur != '{') return fail("type error: expecting object");
+                // objects without members accept any member, same as Json_object_descriptor::json_parse
+                if (o.members_descriptor.values.empty()) return any_object();
+                if (!nest()) return false;
+                cur++;
+                Member_flags loaded(o.members_name.size());
+                if (skip_blanks() != '}') {
+                    while (true) {
+                        const char *start, *stop;
+                        bool escaped;
+                        skip_blanks();
+                        auto name_position = cur;
+                        if (!member_name(start, stop, escaped)) return false;
+                        int m = find_member(o, start, stop, escaped);
+                        bool ok;
+                        if (m >= 0) {
+                            if (loaded.test(m)) {
+                                prepend(start, stop, escaped);
+                                return fail("duplicated definition found for member", name_position);
+                            }
+                            loaded.set(m);
+                            if (skip_blanks() == 'n') {
+                                if (o.members_mandatory[m]) {
+                                    prepend(start, stop, escaped);
+                                    return fail("mandatory member cannot be null");
+                                }
+                                ok = literal("null");
+                            } else {
+                                ok = value(*o.members_descriptor.values[m]);
+                            }
+                        } else {
+                            if (!o.allow_undefined_members) {
+                                prepend(start, stop, escaped);
+                                return fail("member is not defined", name_position);
+                            }
+                            ok = any_value();
+                        }
+                        if (!ok) {
+                            prepend(start, stop, escaped);
+                            return false;
+                        }
+                        char c = skip_blanks();
+                        if (c == '}') break;
+                        if (c != ',') return fail("format error: expecting '}'");
+                        cur++;
+                    }
+                }
+                for (size_t m = 0; m < o.members_name.size(); m++) {
+                    if (o.members_mandatory[m] && !loaded.test(m)) {
+                        auto &name = o.members_name[m];
+                        prepend(name.data(), name.data() + name.size(), false);
+                        return fail("mandatory member missing");
+                    }
+                }
+                cur++;
+                depth--;
+                return true;
+            }
+
+            // same checks as object, driven by the static member table
+            bool static_object(const Json_static_object_base &o) {
+                if (*cur != '{') return fail("type error: expecting object");
+                if (!nest()) return false;
+                cur++;
+                Member_flags loaded(o.member_count());
+                if (skip_blanks() != '}') {
+                    while (true) {
+                        const char *start, *stop;
+                        bool escaped;
+                        skip_blanks();
+                        auto name_position = cur;
+                        if (!member_name(start, stop, escaped)) return false;
+                        int m = o.member_index(escaped ? unescape(start, stop) : string(start, stop));
+                        bool ok;
+                        if (m >= 0) {
+                            if (loaded.test(m)) {
+                                prepend(start, stop, escaped);
+                                return fail("duplicated definition found for member", name_position);
+                            }
+                            loaded.set(m);
+                            if (skip_blanks() == 'n') {
+                                if (o.member_mandatory(m)) {
+                                    prepend(start, stop, escaped);
+                                    return fail("mandatory member cannot be null");
+                                }
+                                ok = literal("null");
+                            } else {
+                                ok = static_member(o, (size_t) m);
+                            }
+                        } else {
+                            if (!o.allow_undefined_members) {
+                                prepend(start, stop, escaped);
+                                return fail("member is not defined", name_position);
+                            }
+                            ok = any_value();
+                        }
+                        if (!ok) {
+                            prepend(start, stop, escaped);
+                            return false;
+                        }
+                        char c = skip_blanks();
+                        if (c == '}') break;
+                        if (c != ',') return fail("format error: expecting '}'");
+                        cur++;
+                    }
+                }
+                for (size_t m = 0; m < o.member_count(); m++) {
+                    if (o.member_mandatory(m) && !loaded.test(m)) {
+                        auto name = o.member_name(m);
+                        prepend(name, name + strlen(name), false);
+                        return fail("mandatory member missing");
+                    }
+                }
+                cur++;
+                depth--;
+                return true;
+            }
+
+            // the value is delimited by any_value, then read by the member codec: errors inside it are reported at the member
+            bool static_member(const Json_static_object_base &o, size_t m) {
+                auto start = cur;
+                if (!any_value()) return false;
+                Slice_buffer slice(start, cur);
+                istream i(&slice);
+                try {
+                    o.check_member(m, i);
+                } catch (const exception &e) {
+                    codec_reason = e.what();
+                    return fail(codec_reason.c_str(), start);
+                }
+                return true;
+            }
+
+            bool list(const Json_list_descriptor &l) {
+                if (*cur != '[') return fail("type error: expecting list");
+                if (!nest()) return false;
+                cur++;
+                if (skip_blanks() != ']') {
+                    for (size_t index = 0;; index++) {
+                        bool ok;
+                        if (skip_blanks() == 'n') {
+                            if (!l.allow_null_values) {
+                                prepend(index);
+                                return fail("null values not allowed");
+                            }
+                            ok = literal("null");
+                        } else {
+                            ok = l.item_descriptor ? value(*l.item_descriptor) : any_value();
+                        }
+                        if (!ok) {
+                            prepend(index);
+                            return false;
+                        }
+                        char c = skip_blanks();
+                        if (c == ']') break;
+                        if (c != ',') return fail("format error: expecting ']'");
+                        cur++;
+                    }
+                }
+                cur++;
+                depth--;
+                return true;
+            }
+
+            bool value(const Json_descriptor &schema) {
+                char c = skip_blanks();
+                if (cur >= end) return fail("format error: unexpected end of input");
+                if (dynamic_cast<const Json_variant_descriptor *>(&schema)) return any_value();
+                if (auto o = dynamic_cast<const Json_object_descriptor *>(&schema)) return object(*o);
+                if (auto l = dynamic_cast<const Json_list_descriptor *>(&schema)) return list(*l);
+                if (auto so = dynamic_cast<const Json_static_object_base *>(&schema)) return static_object(*so);
+                bool is_integer;
+                switch (schema.get_type()) {
+                    case Json_descriptor::Json_descriptor_type::Null:
+                        if (c != 'n') return fail("type error: expecting null");
+                        return literal("null");
+                    case Json_descriptor::Json_descriptor_type::Bool:
+                        if (c == 't') return literal("true");
+                        if (c == 'f') return literal("false");
+                        return fail("type error: expecting bool");
+                    case Json_descriptor::Json_descriptor_type::Int:
+                        if (c != '-' && !is_digit(c)) return fail("type error: expecting int");
+                        return int_value();
+                    case Json_descriptor::Json_descriptor_type::Float:
+                        if (c != '-' && !is_digit(c)) return fail("type error: expecting float");
+                        return number(is_integer);
+                    case Json_descriptor::Json_descriptor_type::String:
+                        if (c != '"') return fail("type error: expecting string");
+                        return string_value();
+                    case Json_descriptor::Json_descriptor_type::Object:
+                        if (c != '{') return fail("type error: expecting object");
+                        return any_object();
+                    case Json_descriptor::Json_descriptor_type::List:
+                        if (c != '[') return fail("type error: expecting list");
+                        return any_list();
+                }
+                return any_value();
+            }
+        };
+    }
+
+    Json_validation_result validate(const Json_descriptor &schema, const char *buffer, size_t size) {
+        Json_validator validator(buffer, size);
+        Json_validation_result result;
+        if (validator.value(schema)) {
+            validator.skip_blanks();
+            if (validator.cur == validator.end) return result;
+            validator.fail("format error: unexpected characters after value");
+        }
+        result.valid = false;
+        result.path = validator.path;
+        result.offset = (size_t) (validator.error_at - validator.begin);
+        result.reason = validator.reason;
+        return result;
+    }
+
+    Json_validation_result validate(const Json_descriptor &schema, const std::string &buffer) {
+        return validate(schema, buffer.data(), buffer.size());
+    }
+}
@@ -0,0 +1,163 @@
+#include "../include/json_writer.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+namespace json_cpp {
+
+    Json_writer::Json_writer(const std::string &file_path, Json_writer_mode mode, size_t buffer_size, bool background) :
+            mode(mode),
+            stream(this),
+            buffer(max<size_t>(buffer_size, 1)) {
+        file = fopen(file_path.c_str(), "wb");
+        if (!file) throw runtime_error("unable to open file " + file_path);
+        // the writer does its own buffering
+        setvbuf(file, nullptr, _IONBF, 0);
+        setp(buffer.data(), buffer.data() + buffer.size());
+        // errors raised by submit while a descriptor is writing to the stream are propagated
+        stream.exceptions(ios::badbit);
+        if (background) {
+            pending.resize(buffer.size());
+            flusher = thread(&Json_writer::flush_loop, this);
+        }
+    }
+
+    Json_writer::~Json_writer() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    bool Json_writer::is_open() const {
+        return file != nullptr;
+    }
+
+    void Json_writer::begin_record() {
+        if (!file) throw logic_error("writer is closed");
+        if (mode == Json_writer_mode::Value && records) throw logic_error("writer in value mode holds a single record");
+        if (mode == Json_writer_mode::Array) sputc(records ? ',' : '[');
+    }
+
+    void Json_writer::end_record() {
+        if (mode == Json_writer_mode::Ndjson) sputc('\n');
+        records++;
+    }
+
+    void Json_writer::write(const Json_descriptor &descriptor) {
+        begin_record();
+        descriptor.json_write(stream);
+        end_record();
+    }
+
+    void Json_writer::write(const std::string &json) {
+        begin_record();
+        xsputn(json.data(), (streamsize) json.size());
+        end_record();
+    }
+
+    int Json_writer::overflow(int c) {
+        submit();
+        if (c != traits_type::eof()) {
+            *pptr() = (char) c;
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize Json_writer::xsputn(const char *s, std::streamsize n) {
+        streamsize written = 0;
+        while (written < n) {
+            auto available = epptr() - pptr();
+            if (available == 0) {
+                submit();
+                continue;
+            }
+            auto chunk = min<streamsize>(available, n - written);
+            memcpy(pptr(), s + written, (size_t) chunk);
+            pbump((int) chunk);
+            written += chunk;
+        }
+        return n;
+    }
+
+    void Json_writer::submit() {
+        auto size = (size_t) (pptr() - pbase());
+        if (size == 0) return;
+        if (flusher.joinable()) {
+            unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !pending_ready; });
+            check_error();
+            std::swap(buffer, pending);
+            pending_size = size;
+            pending_ready = true;
+            condition.notify_all();
+        } else {
+            if (fwrite(buffer.data(), 1, size, file) != size) throw runtime_error("error writing to file");
+        }
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    void Json_writer::flush_loop() {
+        unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            condition.wait(lock, [this] { return pending_ready || stopping; });
+            if (!pending_ready) return;
+            lock.unlock();
+            bool written = fwrite(pending.data(), 1, pending_size, file) == pending_size;
+            lock.lock();
+            if (!written) error = "error writing to file";
+            pending_ready = false;
+            condition.notify_all();
+        }
+    }
+
+    void Json_writer::check_error() {
+        if (!error.empty()) throw runtime_error(error);
+    }
+
+    void Json_writer::flush() {
+        if (!file) return;
+        submit();
+        if (flusher.joinable()) {
+            unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !pending_ready; });
+            check_error();
+        }
+        fflush(file);
+    }
+
+    void Json_writer::close() {
+        finish(true);
+    }
+
+    void Json_writer::abort() {
+        finish(false);
+    }
+
+    void Json_writer::finish(bool terminate) {
+        if (!file) return;
+        string failure;
+        try {
+            if (terminate && mode == Json_writer_mode::Array) {
+                if (!records) sputc('[');
+                sputc(']');
+            }
+            flush();
+        } catch (const exception &e) {
+            failure = e.what();
+        }
+        if (flusher.joinable()) {
+            {
+                lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            flusher.join();
+        }
+        fclose(file);
+        file = nullptr;
+        if (!failure.empty()) throw runtime_error(failure);
+    }
+}
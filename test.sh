@@ -8,6 +8,8 @@ python test_basic.py
 python ../json_cpp2/json_list.py
 python ../json_cpp2/json_object.py
 python ../json_cpp2/json_parser.py
-rm *.json
+python ../json_cpp2/json_writer.py
+python ../json_cpp2/json_shared.py
+rm *.json *.ndjson
 )
 
@@ -0,0 +1,53 @@
+import time
+import json_cpp2_core
+from json_cpp2 import JsonList, JsonObject
+
+# native queries against the python loops they replace, on a list of objects built in python
+# and on a list descriptor parsed natively.
+# usage: python benchmark_query.py [item count]
+
+
+def best_of(function, repeat=5):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        function()
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def compare(label, python_loop, native):
+    python_time = best_of(python_loop)
+    native_time = best_of(native)
+    print("%-10s python %8.1f ms   native %8.1f ms   x%.1f" % (label, python_time * 1000, native_time * 1000, python_time / native_time))
+
+
+def group_by_loop(items, member):
+    groups = dict()
+    for item in items:
+        groups.setdefault(item[member], []).append(item)
+    return groups
+
+
+if __name__ == '__main__':
+    import sys
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 200000
+    items = JsonList(JsonObject)
+    for i in range(count):
+        items.append(JsonObject(id=i, kind="even" if i % 2 == 0 else "odd", position=JsonObject(x=i * 0.5, y=-i * 0.5)))
+    print("%d objects built in python" % count)
+    compare("where", lambda: [i for i in items if i.id >= count // 2], lambda: items.where("id", ">=", count // 2))
+    compare("count", lambda: sum(1 for i in items if i.position.x < 100), lambda: items.count("position.x", "<", 100))
+    compare("sum", lambda: sum(i.id for i in items), lambda: items.sum("id"))
+    compare("max", lambda: max(i.position.x for i in items), lambda: items.max("position.x"))
+    compare("group_by", lambda: group_by_loop(items, "kind"), lambda: items.group_by("kind"))
+    compare("get", lambda: [i.position for i in items], lambda: items.get("position"))
+
+    descriptor = json_cpp2_core.JsonListDescriptor()
+    descriptor.from_json(str(items))
+    print("%d objects parsed natively" % count)
+    operand = json_cpp2_core.get_descriptor(count // 2)
+    compare("where", lambda: [i for i in items if i.id >= count // 2], lambda: json_cpp2_core.where_indices(descriptor, "id", ">=", operand))
+    compare("sum", lambda: sum(i.id for i in items), lambda: json_cpp2_core.aggregate(descriptor, "id"))
+    compare("group_by", lambda: group_by_loop(items, "kind"), lambda: json_cpp2_core.group_by_indices(descriptor, "kind"))
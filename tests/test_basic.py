@@ -1,3 +1,5 @@
+import os
+import pickle
 import unittest
 from json_cpp2 import *
 
@@ -164,11 +166,128 @@ class Parse(unittest.TestCase):
         c = Coordinates.parse("{\"x\":-10, \"y\":-10}")
         c.to_file("coordinates.json")
 
+    def test_validate(self):
+        Coordinates = JsonObject.create_class("Coordinates", x=int, y=int, _mandatory_members=["x", "y"], _allow_undefined_members=False)
+        self.assertTrue(Coordinates.validate("{\"x\":10, \"y\":-10}"))
+        r = Coordinates.validate("{\"x\":10}")
+        self.assertFalse(r)
+        self.assertEqual(r.path, "/y")
+        r = Coordinates.validate("{\"x\":10, \"y\":1.5}")
+        self.assertFalse(r.valid)
+        self.assertEqual(r.path, "/y")
+        self.assertEqual(r.offset, 13)
+        self.assertFalse(Coordinates.validate("{\"x\":10,\"y\":15,\"z\":20}"))
+        IntList = JsonList.create_class("IntList", int, allow_null_values=False)
+        results = IntList.validate_batch(["[1,2,3]", b"[1,null]", "[1,\"a\"]"])
+        self.assertEqual([bool(r) for r in results], [True, False, False])
+        self.assertEqual(results[1].path, "/1")
+
+    def test_writer(self):
+        with JsonWriter("writer.json") as writer:
+            writer.write(JsonObject(x=1))
+            writer.write_all([1, None, "ok"])
+        self.assertEqual(open("writer.json").read(), "[{\"x\":1},1,null,\"ok\"]")
+        with JsonWriter("writer.json", mode="ndjson", buffer_size=8, background=True) as writer:
+            for i in range(100):
+                writer.write({"i": i})
+            self.assertEqual(writer.records, 100)
+        lines = open("writer.json").read().splitlines()
+        self.assertEqual(len(lines), 100)
+        self.assertEqual(JsonParser.parse(lines[99]).i, 99)
+        JsonList(int, [1, 2, 3]).to_file("writer.json")
+        self.assertEqual(JsonParser.from_file("writer.json"), [1, 2, 3])
+        with self.assertRaises(ValueError):
+            with JsonWriter("writer.json") as writer:
+                writer.write(1)
+                raise ValueError()
+        self.assertEqual(open("writer.json").read(), "[1")
+
+    def test_diff_and_patch(self):
+        a = JsonParser.parse("{\"a\":1,\"b\":{\"c\":\"x\"},\"d\":[1,2,3]}")
+        b = JsonParser.parse("{\"a\":1,\"b\":{\"c\":\"y\"},\"d\":[0,1,2,3],\"e\":true}")
+        patch = JsonParser.diff(a, b)
+        self.assertEqual(len(patch), 3)
+        self.assertEqual(patch[0].op, "replace")
+        self.assertEqual(patch[0].path, "/b/c")
+        source = str(a)
+        d = a.d
+        self.assertIs(JsonParser.apply_patch(a, patch), a)
+        self.assertEqual(str(a), str(b))
+        self.assertIs(a.d, d)
+        self.assertEqual(str(JsonParser.apply_patch(JsonParser.parse(source), str(patch))), str(b))
+        merge_patch = JsonParser.diff(JsonParser.parse(source), b, merge_patch=True)
+        self.assertEqual(str(merge_patch), "{\"b\":{\"c\":\"y\"},\"d\":[0,1,2,3],\"e\":true}")
+        self.assertEqual(str(JsonParser.apply_patch(JsonParser.parse(source), merge_patch, merge_patch=True)), str(b))
+        JsonParser.apply_patch(a, "{\"e\":null}", merge_patch=True)
+        self.assertFalse(hasattr(a, "e"))
+        self.assertRaises(RuntimeError, JsonParser.apply_patch, a, "[{\"op\":\"test\",\"path\":\"/a\",\"value\":2}]")
+        self.assertEqual(a.a, 1)
+        self.assertRaises(RuntimeError, JsonParser.apply_patch, a, "[{\"op\":\"remove\",\"path\":\"/a\"},{\"op\":\"add\",\"path\":\"/d/0\",\"value\":5},{\"op\":\"remove\",\"path\":\"/x\"}]")
+        self.assertEqual(str(a), str(b).replace(",\"e\":true", ""))
+        self.assertIs(a.d, d)
+        self.assertEqual(JsonParser.apply_patch(10, "[{\"op\":\"replace\",\"path\":\"\",\"value\":\"x\"}]"), "x")
+        self.assertEqual(str(JsonParser.apply_patch(10, "{\"a\":1}", merge_patch=True)), "{\"a\":1}")
+
+    def test_query(self):
+        l = JsonList(JsonObject)
+        for i in range(10):
+            l.append(JsonObject(id=i, kind="even" if i % 2 == 0 else "odd", position=JsonObject(x=i * 1.5)))
+        self.assertEqual(l.where("id", ">=", 7).get("id"), [7, 8, 9])
+        self.assertIs(l.where("kind", "==", "odd")[0], l[1])
+        self.assertEqual(l.where("position.x", "<", 3).get("id"), [0, 1])
+        self.assertEqual(l.count("kind", "!=", "odd"), 5)
+        self.assertEqual(l.sum("id"), 45)
+        self.assertEqual(l.min("position.x"), 0.0)
+        self.assertEqual(l.max("position.x"), 13.5)
+        self.assertEqual(JsonList(int).max(), None)
+        groups = l.group_by("kind")
+        self.assertEqual(list(groups.keys()), ["even", "odd"])
+        self.assertEqual(groups["odd"].get("id"), [1, 3, 5, 7, 9])
+        self.assertEqual(str(l.select(["id"])[2]), "{\"id\":2}")
+        self.assertIs(l.select(["position"])[3].position, l[3].position)
+        self.assertIs(l.get("position")[3], l[3].position)
+        self.assertRaises(ValueError, l.where, "id", "=~", 1)
+        self.assertRaises(RuntimeError, l.sum, "kind")
+        l[0].id = 100
+        self.assertEqual(l.max("id"), 100)
+        l.pop()
+        self.assertEqual(l.sum("id"), 136)
+        self.assertEqual(JsonList(JsonObject, [JsonObject(x=0.1)]).get("x"), [0.1])
+        self.assertEqual(JsonList(int, [2 ** 31 - 1, 2 ** 31 - 1]).sum(), 2 ** 32 - 2)
+        self.assertRaises(OverflowError, JsonList(int, [2 ** 40]).sum)
+        keys = JsonList(JsonObject, [JsonObject(k="1"), JsonObject(k=1), JsonObject(k="null"), JsonObject(k=None), JsonObject()])
+        self.assertEqual(list(keys.group_by("k").keys()), ["1", 1, "null", None])
+
+    def test_shared_document(self):
+        value = JsonObject(id=1, name="shared", items=JsonList(float, [0.5, 1.5]), nested=JsonObject(ok=True, none=None))
+        document = JsonSharedDocument.create(value, file_path="shared.json_shared")
+        reader = pickle.loads(pickle.dumps(document))
+        self.assertEqual(reader.to_json(), str(value))
+        self.assertEqual(reader["name"], "shared")
+        self.assertEqual(reader.root.items[-1], 1.5)
+        self.assertEqual(len(reader.root.items), 2)
+        self.assertEqual(reader.root.nested.none, None)
+        self.assertEqual(reader.root.keys(), ["id", "name", "items", "nested"])
+        self.assertEqual(list(reader.root), ["id", "name", "items", "nested"])
+        self.assertEqual(list(reader.root.items), [0.5, 1.5])
+        items = iter(reader.root.items)
+        self.assertIs(iter(items), items)
+        self.assertEqual(next(items), 0.5)
+        self.assertEqual(list(items), [1.5])
+        self.assertTrue("nested" in reader.root)
+        self.assertRaises(KeyError, lambda: reader["missing"])
+        self.assertRaises(AttributeError, lambda: reader.root.missing)
+        self.assertRaises(IndexError, lambda: reader.root.items[2])
+        self.assertEqual(str(reader.load()), str(value))
+        os.remove("shared.json_shared")
+
     def test_to_json(self):
         self.assertEqual(JsonParser.to_json(None), "null")
         self.assertEqual(JsonParser.to_json(1), "1")
         self.assertEqual(JsonParser.to_json(True), "true")
         self.assertEqual(JsonParser.to_json(15.5), "15.5")
+        self.assertEqual(JsonParser.to_json(0.1 + 0.2), "0.30000000000000004")
+        self.assertEqual(JsonParser.parse("3.141592653589793"), 3.141592653589793)
         self.assertEqual(JsonParser.to_json("ok"), "\"ok\"")
         self.assertEqual(JsonParser.to_json([1, 2, 3]), "[1,2,3]")
         self.assertEqual(JsonParser.to_json((1, 2, 3)), "[1,2,3]")